@@ -18,6 +18,48 @@
 #include <linux/dmi.h>
 #include <linux/acpi.h>
 #include <linux/limits.h>
+#include <linux/mutex.h>
+#include <linux/jiffies.h>
+#include <linux/debugfs.h>
+#include <linux/miscdevice.h>
+#include <linux/kfifo.h>
+#include <linux/poll.h>
+#include <linux/workqueue.h>
+#include <linux/uaccess.h>
+#include <linux/idr.h>
+#include <linux/slab.h>
+#include <linux/list.h>
+#include <linux/rcupdate.h>
+#include <linux/percpu.h>
+#include <linux/seq_file.h>
+#include <linux/seq_buf.h>
+#include <linux/platform_device.h>
+#include <linux/sort.h>
+#include <linux/reboot.h>
+#include <linux/capability.h>
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_IIO
+#include <linux/iio/iio.h>
+#include <linux/iio/buffer.h>
+#include <linux/iio/trigger_consumer.h>
+#include <linux/iio/triggered_buffer.h>
+#endif
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+#include <linux/perf_event.h>
+#include <linux/cpumask.h>
+#include <linux/cpuhotplug.h>
+#include <linux/ctype.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ASUS_PRIMEB550PLUS_HWMON_KUNIT_TEST)
+#include <kunit/visibility.h>
+#endif
+
+#include "asus_primeb550plus_hwmon.h"
+#include "asus_primeb550plus_hwmon_decode.h"
+#include "asus_primeb550plus_hwmon_kunit.h"
+
+#define CREATE_TRACE_POINTS
+#include "asus_primeb550plus_hwmon_trace.h"
 
 static const struct dmi_system_id asus_accepted_dmis[] = {
 	{
@@ -48,102 +90,343 @@ static const struct dmi_system_id asus_accepted_dmis[] = {
 	{ .matches = { { .slot = DMI_NONE } } }
 };
 
-struct asus_primeb550plus_hwmon_data {
-	struct acpi_device *acpi_dev;
-	struct device *device;
-	acpi_handle acpi_dev_handle;
-
-	acpi_handle rhwm_method;
-};
-
 static const struct acpi_device_id asus_primeb550plus_hwmon_acpi_ids[] = {
 	{"PNP0C14"},
 	{""},
 };
 MODULE_DEVICE_TABLE(acpi, asus_primeb550plus_hwmon_acpi_ids);
 
-static int asus_primeb550plus_hwmon_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
-{
-	unsigned char a_buf[2] = { bank, index };
-	union acpi_object buf_args = {
-		.type = ACPI_TYPE_BUFFER,
-		.buffer = {
-			.type = ACPI_TYPE_BUFFER,
-			.length = 2,
-			.pointer = a_buf,
-		},
-	};
-	struct acpi_object_list acpi_args = {
-		.count = 1,
-		.pointer = &buf_args,
-	};
-	unsigned long long val;
-	acpi_status a_r;
+#define ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_DEFAULT	1000	/* ms */
+#define ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_MIN		100	/* ms */
+#define ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_MAX		60000	/* ms */
 
-	a_r = acpi_evaluate_integer(devdri_data->rhwm_method, NULL, &acpi_args, &val);
-	if (!ACPI_SUCCESS(a_r))
-		return -1;
-	
-	if (val > U8_MAX)
-		return -1;
+#define ASUS_B550PLUS_HWMON_PAIRED_READ_RETRIES	3
 
-	*dest = val;
-	return 0;
-}
+/* low_wakeup: the sampler slows down after this many periods without a reader */
+#define ASUS_B550PLUS_HWMON_SAMPLER_IDLE_PERIODS	4
+#define ASUS_B550PLUS_HWMON_SAMPLER_SLACK_DEFAULT	500	/* ms */
+#define ASUS_B550PLUS_HWMON_MAX_STALENESS_DEFAULT	5000	/* ms */
 
-enum asus_primeb550plus_hwmon_data_type {
-	ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL,
-	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT,
-	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT,
-	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT,
-	ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16,
-};
+#define ASUS_B550PLUS_HWMON_ALL_FIELDS	GENMASK_ULL(ASUS_B550PLUS_HWMON_FIELD_LIST_MAX - 1, 0)
+
+/* Samples taken by a detection pass to find channels with something connected */
+#define ASUS_B550PLUS_HWMON_PRESENCE_SAMPLES	5
+#define ASUS_B550PLUS_HWMON_PRESENCE_DELAY	50	/* ms */
+#define ASUS_B550PLUS_HWMON_PRESENCE_RECHECK_DEFAULT	60	/* s */
+
+/* A field of rate class n is read every update_interval << n */
+#define ASUS_B550PLUS_HWMON_RATE_CLASSES	7
+#define ASUS_B550PLUS_HWMON_ADAPTIVE_MAX_INTERVAL_DEFAULT	16000	/* ms */
+
+#define ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_DEFAULT	60000	/* ms */
+#define ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_MIN	1000	/* ms */
+#define ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_MAX	86400000	/* ms */
+
+#define ASUS_B550PLUS_HWMON_STREAM_PERIOD_DEFAULT	1000	/* ms */
+#define ASUS_B550PLUS_HWMON_STREAM_PERIOD_MIN		10	/* ms */
+#define ASUS_B550PLUS_HWMON_STREAM_PERIOD_MAX		60000	/* ms */
+#define ASUS_B550PLUS_HWMON_STREAM_DEPTH		64	/* samples, power of 2 */
+
+#define ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS		4096
 
-struct asus_primeb550plus_hwmon_data_type_uchar_mul {
-	unsigned char bank_no;
-	unsigned char index_in_bank;
-	int multiplier;
+#define ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_DEFAULT	512	/* KiB */
+#define ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_MAX		65536	/* KiB */
+/* Worst case of an encoded sample: varints of time, valid and every channel */
+#define ASUS_B550PLUS_HWMON_ARCHIVE_SAMPLE_MAX	((2 + ASUS_B550PLUS_HWMON_FIELD_LIST_MAX) * 10)
+
+/* debugfs 'metrics', fits every channel with room to spare */
+#define ASUS_B550PLUS_HWMON_METRICS_SIZE	8192
+
+#define ASUS_B550PLUS_HWMON_WATCHDOG_FANS_DEFAULT	0x3	/* sysfan, cpufan */
+#define ASUS_B550PLUS_HWMON_WATCHDOG_TEMPS_DEFAULT	BIT(12)	/* temp13, PCH CPU temperature */
+#define ASUS_B550PLUS_HWMON_WATCHDOG_DEBOUNCE_DEFAULT	3	/* sweeps */
+/* Given to hw_protection_shutdown(), poweroff is forced if the orderly one takes longer */
+#define ASUS_B550PLUS_HWMON_WATCHDOG_FORCE_MS		10000
+
+/* Banks with a circuit breaker, every register the driver reads lives below */
+#define ASUS_B550PLUS_HWMON_BREAKER_BANKS	16
+#define ASUS_B550PLUS_HWMON_BREAKER_THRESHOLD_DEFAULT	5	/* consecutive failures */
+#define ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MIN	1000	/* ms */
+#define ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MAX	60000	/* ms */
+
+#define ASUS_B550PLUS_HWMON_PWM_OUTPUTS		7
+#define ASUS_B550PLUS_HWMON_CURVE_POINTS	4
+#define ASUS_B550PLUS_HWMON_CURVE_TEMP_MIN	-55000	/* m°C */
+#define ASUS_B550PLUS_HWMON_CURVE_TEMP_MAX	150000	/* m°C */
+#define ASUS_B550PLUS_HWMON_CURVE_HYST_MAX	50000	/* m°C */
+
+/*
+ * What readers see: built by whoever holds update_lock after a sweep (or
+ * a history/limit change), published with RCU and never modified after.
+ */
+struct asus_primeb550plus_hwmon_snapshot {
+	struct rcu_head rcu;
+	unsigned long timestamp;	/* jiffies of the sweep */
+	u64 timestamp_ns;		/* ktime_get_ns() of the sweep */
+	struct asus_primeb550plus_hwmon_snapshot_field {
+		long value;
+		int error;
+		u64 read_ns;		/* ktime_get_ns() of the read */
+		unsigned int alarms;	/* BIT() of asus_primeb550plus_hwmon_attr_kind */
+		bool history_valid;
+		bool average_valid;
+		long lowest;
+		long highest;
+		long average;
+	} fields[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
 };
 
-struct asus_primeb550plus_hwmon_data_type_temp_9bit {
-	unsigned char int_bank_no;
-	unsigned char int_index_in_bank;
-	unsigned char frac_bank_no;
-	unsigned char frac_index_in_bank;
+struct asus_primeb550plus_hwmon_data;
+
+/* How chip registers are reached */
+struct asus_primeb550plus_hwmon_backend_ops {
+	const char *name;
+	int (*read_u8)(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest);
+	/* Optional, several registers of the same bank */
+	int (*read_block)(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char const *indexes, size_t count, unsigned char *dest);
+	/* Optional, only used by the fan curve engine */
+	int (*write_u8)(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value);
 };
 
-struct asus_primeb550plus_hwmon_data_type_temp_8bit {
-	unsigned char bank_no;
-	unsigned char index_in_bank;
+#define ASUS_B550PLUS_HWMON_PLAN_SLOTS (2 * ASUS_B550PLUS_HWMON_FIELD_LIST_MAX)
+
+/*
+ * Every register the field table needs, once, sorted by (bank, index),
+ * compiled at probe. A sweep reads runs of the same bank into a flat byte
+ * array, then reads again the high bytes of two-byte fields (verify
+ * runs) to detect values that moved in between.
+ */
+struct asus_primeb550plus_hwmon_plan_run {
+	unsigned char bank;
+	unsigned short first;	/* slot */
+	unsigned short count;
 };
 
-struct asus_primeb550plus_hwmon_data_type_temp_14bit {
-	unsigned char int_bank_no;
-	unsigned char int_idx;
-	unsigned char frac_bank_no;
-	unsigned char frac_idx;
+struct asus_primeb550plus_hwmon_read_plan {
+	unsigned int nr_slots;
+	unsigned char banks[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	unsigned char indexes[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	unsigned int nr_runs;
+	struct asus_primeb550plus_hwmon_plan_run runs[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+
+	unsigned int nr_verify;
+	unsigned short verify_slots[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	unsigned char verify_indexes[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	unsigned int nr_verify_runs;
+	struct asus_primeb550plus_hwmon_plan_run verify_runs[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+
+	struct {
+		unsigned char nr_regs;
+		unsigned short slots[2];
+		unsigned short verify;	/* two-byte fields only */
+	} fields[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
 };
 
-struct asus_primeb550plus_hwmon_data_type_pwm16 {
-	unsigned char high_bank_no;
-	unsigned char high_idx;
-	unsigned char low_bank_no;
-	unsigned char low_idx;
+/* Banks covered by latency histograms, all fields live below */
+#define ASUS_B550PLUS_HWMON_LATENCY_BANKS 8
+/* Bucket n counts reads that took [2^(n-1), 2^n) ns */
+#define ASUS_B550PLUS_HWMON_LATENCY_BUCKETS 32
+
+struct asus_primeb550plus_hwmon_backend_stats {
+	u64 calls;
+	u64 errors;
+	u64 latency[ASUS_B550PLUS_HWMON_LATENCY_BANKS][ASUS_B550PLUS_HWMON_LATENCY_BUCKETS];
 };
 
-struct asus_primeb550plus_hwmon_chip_field {
-	enum asus_primeb550plus_hwmon_data_type data_type;
-	union {
-		struct asus_primeb550plus_hwmon_data_type_uchar_mul uchar_mul;
-		struct asus_primeb550plus_hwmon_data_type_temp_9bit temp_9bit;
-		struct asus_primeb550plus_hwmon_data_type_temp_8bit temp_8bit;
-		struct asus_primeb550plus_hwmon_data_type_temp_14bit temp_14bit;
-		struct asus_primeb550plus_hwmon_data_type_pwm16 pwm16;
-	} data_address;
-	char const * label;
+struct asus_primeb550plus_hwmon_data {
+	struct acpi_device *acpi_dev;
+	struct device *parent;		/* ACPI or platform device the frontends are registered on */
+	struct device *device;		/* hwmon device, NULL until the first detection pass is over */
+	acpi_handle acpi_dev_handle;
+
+	acpi_handle rhwm_method;
+
+	struct asus_primeb550plus_hwmon_backend_ops const *backend;
+	void *backend_data;
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+	struct asus_primeb550plus_hwmon_emulated *emulated;
+#endif
+	struct asus_primeb550plus_hwmon_backend_stats __percpu *backend_stats;
+	struct asus_primeb550plus_hwmon_read_plan plan;
+
+	/*
+	 * Per bank, protected by update_lock. Open (backoff set) after
+	 * breaker_threshold consecutive failures: reads fail at once with
+	 * EBUSY, until retry_at lets one through. Its success closes the
+	 * breaker, its failure doubles backoff.
+	 */
+	struct asus_primeb550plus_hwmon_breaker {
+		unsigned int failures;		/* consecutive */
+		unsigned int backoff;		/* ms, 0 when closed */
+		unsigned long retry_at;		/* jiffies */
+		u64 errors;
+		u64 trips;
+		u64 rejected;
+	} breakers[ASUS_B550PLUS_HWMON_BREAKER_BANKS];
+
+	/* Ring of the last register reads, protected by update_lock */
+	struct {
+		bool enabled;
+		u64 start_ns;
+		unsigned int head;	/* records ever written */
+		struct asus_primeb550plus_hwmon_raw_record *records;
+	} raw_trace;
+	u64 present;			/* BIT_ULL() of fields with something connected, only grows */
+
+	/* Detection pass over the fields not present yet, protected by update_lock */
+	struct {
+		unsigned int samples;
+		u64 readable;
+		u64 varying;
+		long first[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	} presence;
+	struct delayed_work presence_work;
+	bool registered;		/* hwmon, IIO and PMU, after the first detection pass */
+
+	/*
+	 * Every sweep, compressed (see asus_primeb550plus_hwmon.h) in a ring
+	 * of blocks, protected by update_lock. Below blocks is the state the
+	 * next sample is encoded against.
+	 */
+	struct {
+		struct asus_primeb550plus_hwmon_archive_block *blocks;
+		unsigned int nr_blocks;
+		unsigned int head;		/* blocks ever started */
+		u64 last_ms;			/* since start_ns of the current block */
+		u64 valid;
+		long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	} archive;
+
+	/*
+	 * Every field is read in one sweep by the sampler (the only one
+	 * touching the chip, along with streams wanting a faster pace).
+	 * Everything below up to snapshot is producer state, protected by
+	 * update_lock; readers only dereference snapshot.
+	 */
+	struct mutex update_lock;
+	bool valid;
+	bool dirty;			/* snapshot needs to be published again */
+	unsigned long last_updated;	/* jiffies */
+	u64 last_updated_ns;		/* ktime_get_ns() */
+	unsigned long update_interval;	/* ms */
+	long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	u64 read_ns[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];	/* ktime_get_ns() of the read */
+	struct asus_primeb550plus_hwmon_snapshot __rcu *snapshot;
+	u64 __percpu *cache_hits;	/* reads served from snapshot */
+	u64 cache_misses;		/* sweeps */
+	u64 paired_read_retries;
+	u64 paired_read_failures;
+	u64 plan_verify_mismatches;	/* two-byte fields of a sweep read again on their own */
+
+	/*
+	 * Limits only live here, the chip is never written. They are
+	 * checked after every sweep, alarm changes are notified once
+	 * update_lock is released.
+	 */
+	struct asus_primeb550plus_hwmon_limits {
+		long min;
+		long max;
+		long crit;
+	} limits[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	unsigned int alarms[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];		/* BIT() of asus_primeb550plus_hwmon_attr_kind */
+	unsigned int alarms_changed[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];	/* same, not notified yet */
+	struct delayed_work sampler_work;
+	struct delayed_work sampler_timely_work;	/* low_wakeup: never deferred, used while curves or the watchdog run */
+
+	/* Sampler pace and statistics, only touched by the sampler unless stated */
+	unsigned long sampler_period;	/* ms, above update_interval when backed off */
+	bool sampler_timely;		/* sampler_timely_work is the one to queue, also set by pwm writes */
+	u64 sampler_last_ns;		/* ktime_get_ns() of the last wakeup */
+	u64 sampler_wakeups;
+	u64 sampler_achieved_us;	/* moving average of the time between wakeups */
+	u64 catch_ups;			/* sweeps done by readers, protected by update_lock */
+	unsigned long last_consumed;	/* jiffies, written by readers */
+
+	/* Fan stall and overtemperature watchdog, protected by update_lock */
+	struct asus_primeb550plus_hwmon_watchdog {
+		unsigned int count;		/* sweeps in a row past the threshold */
+		u64 first_ns;			/* sweep of the first of them */
+		bool tripped;			/* until the field gets back */
+	} watchdog[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	u64 watchdog_trips;
+	u64 watchdog_latency_ns;	/* detection to action of the last trip */
+	u64 watchdog_latency_max_ns;
+	u64 watchdog_debounce_ns;	/* first reading past the threshold to detection, last trip */
+
+	/* Extremes and average of what the sweeps have seen */
+	struct asus_primeb550plus_hwmon_history {
+		bool valid;
+		long lowest;
+		long highest;
+		bool average_valid;
+		long average;			/* over the last complete window */
+		s64 sum;			/* of the current window */
+		unsigned int samples;
+		unsigned long window_start;	/* jiffies */
+		unsigned long average_interval;	/* ms */
+	} history[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+
+	/* When each field is read next, slower for fields that barely move */
+	struct asus_primeb550plus_hwmon_schedule {
+		bool seen;
+		long previous;			/* value at the last read */
+		long change;			/* moving average of |delta|, times 16 */
+		unsigned int rate_class;
+		unsigned int interval;		/* ms */
+		unsigned long next_due;		/* jiffies */
+	} schedule[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+
+	/*
+	 * Fan curve engine: outputs in ASUS_B550PLUS_HWMON_PWM_CURVE mode get
+	 * a duty computed from their temperatures after every sweep. Nothing
+	 * is written to the chip unless writable.
+	 */
+	bool writable;
+	u64 chip_writes;
+	u64 chip_write_errors;
+	struct asus_primeb550plus_hwmon_fan_curve {
+		unsigned int enable;		/* enum asus_primeb550plus_hwmon_pwm_enable */
+		unsigned long temp_channels;	/* BIT() of temp channels, the hottest is used */
+		long point_temps[ASUS_B550PLUS_HWMON_CURVE_POINTS];	/* m°C, increasing */
+		unsigned char point_pwms[ASUS_B550PLUS_HWMON_CURVE_POINTS];
+		long hyst;			/* m°C */
+		bool temp_valid;
+		long temp;			/* m°C the curve was last evaluated at */
+		bool pwm_valid;			/* pwm is what the chip has */
+		unsigned char pwm;
+		unsigned char saved_mode;	/* mode register before the chip lost control */
+	} fan_curves[ASUS_B550PLUS_HWMON_PWM_OUTPUTS];
+
+	/* Attributes the hwmon core has no standard for, see asus_primeb550plus_hwmon_extra_attr_suffixes */
+	struct asus_primeb550plus_hwmon_extra_attr {
+		struct sensor_device_attribute_2 sda;
+		char name[32];
+	} *extra_attrs;
+	struct attribute **extra_attr_ptrs;
+	struct attribute_group extra_group;
+	const struct attribute_group *extra_groups[2];
+
+	struct dentry *debugfs_dir;
+
+	int instance;
+	char miscdev_name[32];
+	struct miscdevice miscdev;
+	struct list_head streams;	/* protected by asus_primeb550plus_hwmon_streams_lock */
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+	struct pmu pmu;
+	char pmu_name[32];
+	int pmu_cpu;			/* every event counts there, moved when it goes offline */
+	struct hlist_node pmu_node;	/* in asus_primeb550plus_hwmon_pmu_hp_state */
+	struct asus_primeb550plus_hwmon_pmu_attr *pmu_attrs;
+	struct attribute **pmu_attr_ptrs;
+	struct attribute_group pmu_events_group;
+	const struct attribute_group *pmu_groups[4];
+#endif
 };
 
-enum asus_primeb550plus_hwmon_field_list {
+static const enum asus_primeb550plus_hwmon_field_list asus_primeb550plus_hwmon_in_fields[] = {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB,
@@ -160,6 +443,9 @@ enum asus_primeb550plus_hwmon_field_list {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN3,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN7,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN9,
+};
+
+static const enum asus_primeb550plus_hwmon_field_list asus_primeb550plus_hwmon_temp_fields[] = {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP2,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP3,
@@ -177,15 +463,15 @@ enum asus_primeb550plus_hwmon_field_list {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP,
 
-	ASUS_B550PLUS_HWMON_FIELD_LIST_CPU_TEMP,
-
 	ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN0,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN1,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN2,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN3,
+};
 
+static const enum asus_primeb550plus_hwmon_field_list asus_primeb550plus_hwmon_fan_fields[] = {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN0,
@@ -193,471 +479,4452 @@ enum asus_primeb550plus_hwmon_field_list {
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN2,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN3,
 	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4,
+};
 
-	ASUS_B550PLUS_HWMON_FIELD_LIST_MAX
-};
-
-#define ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL(_label, _bank_no, _idx_in_bank, _multiplier) \
-	& (const struct asus_primeb550plus_hwmon_chip_field) { \
-		.label = _label "\n", \
-		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL, \
-		.data_address.uchar_mul = { \
-			.bank_no = (_bank_no), \
-			.index_in_bank = (_idx_in_bank), \
-			.multiplier = (_multiplier) \
-		} \
-	}
-
-#define ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT(_label, _int_bank_no, _int_idx, _frac_bank_no, _frac_idx) \
-	& (const struct asus_primeb550plus_hwmon_chip_field) { \
-		.label = _label "\n", \
-		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT, \
-		.data_address.temp_9bit = { \
-			.int_bank_no = (_int_bank_no), \
-			.int_index_in_bank = (_int_idx), \
-			.frac_bank_no = (_frac_bank_no), \
-			.frac_index_in_bank = (_frac_idx), \
-		} \
-	}
-
-#define ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT(_label, _bank_no, _idx) \
-	& (const struct asus_primeb550plus_hwmon_chip_field) { \
-		.label = _label "\n", \
-		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT, \
-		.data_address.temp_8bit = { \
-			.bank_no = (_bank_no), \
-			.index_in_bank = (_idx), \
-		} \
-	}
-
-#define ASUS_B550PLUS_HWMON_FIELD_TEMP_14BIT(_label, _int_bank_no, _int_idx, _frac_bank_no, _frac_idx) \
-	& (const struct asus_primeb550plus_hwmon_chip_field) { \
-		.label = _label "\n", \
-		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT, \
-		.data_address.temp_14bit = { \
-			.int_bank_no = (_int_bank_no), \
-			.int_idx = (_int_idx), \
-			.frac_bank_no = (_frac_bank_no), \
-			.frac_idx = (_frac_idx), \
-		} \
-	}
-
-#define ASUS_B550PLUS_HWMON_FIELD_PWM16(_label, _high_bank_no, _high_idx, _low_bank_no, _low_idx) \
-	& (const struct asus_primeb550plus_hwmon_chip_field) { \
-		.label = _label "\n", \
-		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16, \
-		.data_address.pwm16 = { \
-			.high_bank_no = (_high_bank_no), \
-			.high_idx = (_high_idx), \
-			.low_bank_no = (_low_bank_no), \
-			.low_idx = (_low_idx),\
-		} \
-	}
-
-static struct asus_primeb550plus_hwmon_chip_field const * const asus_primeb550plus_hwmon_chip_fields[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX] = {
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("cpuvcore", 4, 0x80, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin1", 4, 0x81, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("avsb", 4, 0x82, 2*8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_3VCC ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("3vcc", 4, 0x83, 2*8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN0 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin0", 4, 0x84, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN8 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin8", 4, 0x85, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN4 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin4", 4, 0x86, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_3VSB ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("3vsb", 4, 0x87, 2*8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VBAT ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vbat", 4, 0x88, 2*8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VTT ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vtt", 4, 0x89, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN5 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin5", 4, 0x8a, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN6 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin6", 4, 0x8b, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN2 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin2", 4, 0x8c, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN3 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin3", 4, 0x8d, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN7 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin7", 4, 0x8e, 8),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN9 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin9", 4, 0x8f, 8),
-
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp1", 0, 0x73, 0, 0x74),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp2", 0, 0x75, 0, 0x76),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP3 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp3", 0, 0x77, 0, 0x78),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP4 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp4", 0, 0x79, 0, 0x7a),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP5 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp5", 0, 0x7b, 0, 0x7c),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP6 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp6", 0, 0x7d, 0, 0x7e),
-
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent0, dimm0", 4, 0x05),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent0, dimm1", 4, 0x06),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent1, dimm0", 4, 0x07),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent1, dimm1", 4, 0x08),
+/* Sensor attributes handled by the driver, whatever the hwmon sensor type */
+enum asus_primeb550plus_hwmon_attr_kind {
+	ASUS_B550PLUS_HWMON_ATTR_INPUT,
+	ASUS_B550PLUS_HWMON_ATTR_LABEL,
+	ASUS_B550PLUS_HWMON_ATTR_MIN,
+	ASUS_B550PLUS_HWMON_ATTR_MAX,
+	ASUS_B550PLUS_HWMON_ATTR_CRIT,
+	ASUS_B550PLUS_HWMON_ATTR_ALARM,
+	ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM,
+	ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM,
+	ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM,
+	ASUS_B550PLUS_HWMON_ATTR_LOWEST,
+	ASUS_B550PLUS_HWMON_ATTR_HIGHEST,
+	ASUS_B550PLUS_HWMON_ATTR_AVERAGE,
+	ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL,
+	ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY,
+	ASUS_B550PLUS_HWMON_ATTR_AGE,
 
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SMIOVT2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("smiovt2 (default cputin)", 1, 0x50, 1, 0x51),
+	ASUS_B550PLUS_HWMON_ATTR_KIND_MAX
+};
 
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("pch chip", 4, 0x01),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_14BIT("cpu", 4, 0x02, 4, 0x03),
+#define ASUS_B550PLUS_HWMON_ALARM_KINDS	(BIT(ASUS_B550PLUS_HWMON_ATTR_ALARM) | BIT(ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM) | BIT(ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM) | BIT(ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM))
+#define ASUS_B550PLUS_HWMON_LIMIT_KINDS	(BIT(ASUS_B550PLUS_HWMON_ATTR_MIN) | BIT(ASUS_B550PLUS_HWMON_ATTR_MAX) | BIT(ASUS_B550PLUS_HWMON_ATTR_CRIT))
+#define ASUS_B550PLUS_HWMON_HISTORY_KINDS	(BIT(ASUS_B550PLUS_HWMON_ATTR_LOWEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_HIGHEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_AVERAGE) | BIT(ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL) | BIT(ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY))
+/* Provided for every sensor type, whatever the hwmon ABI has */
+#define ASUS_B550PLUS_HWMON_EXTRA_KINDS	(ASUS_B550PLUS_HWMON_HISTORY_KINDS | BIT(ASUS_B550PLUS_HWMON_ATTR_AGE))
+#define ASUS_B550PLUS_HWMON_BASE_KINDS	(BIT(ASUS_B550PLUS_HWMON_ATTR_INPUT) | BIT(ASUS_B550PLUS_HWMON_ATTR_LABEL) | ASUS_B550PLUS_HWMON_LIMIT_KINDS | ASUS_B550PLUS_HWMON_ALARM_KINDS)
 
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("systin", 4, 0x90),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("cputin", 4, 0x91),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin0", 4, 0x92),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin1", 4, 0x93),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin2", 4, 0x94),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN3 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin3", 4, 0x95),
+/* Suffixes of the attributes the hwmon core does not provide for a sensor type */
+static const char * const asus_primeb550plus_hwmon_extra_attr_suffixes[ASUS_B550PLUS_HWMON_ATTR_KIND_MAX] = {
+	[ ASUS_B550PLUS_HWMON_ATTR_LOWEST ] = "lowest",
+	[ ASUS_B550PLUS_HWMON_ATTR_HIGHEST ] = "highest",
+	[ ASUS_B550PLUS_HWMON_ATTR_AVERAGE ] = "average",
+	[ ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL ] = "average_interval",
+	[ ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY ] = "reset_history",
+	[ ASUS_B550PLUS_HWMON_ATTR_AGE ] = "age",
+};
 
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("sysfan", 4, 0xc0, 4, 0xc1),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("cpufan", 4, 0xc2, 4, 0xc3),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN0 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan0", 4, 0xc4, 4, 0xc5),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN1 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan1", 4, 0xc6, 4, 0xc7),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN2 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan2", 4, 0xc8, 4, 0xc9),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN3 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan3", 4, 0xca, 4, 0xcb),
-	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan4", 4, 0xce, 4, 0xcf),
+struct asus_primeb550plus_hwmon_type_desc {
+	enum hwmon_sensor_types type;
+	const char *name;	/* sysfs attribute prefix */
+	int index_base;		/* sysfs number of channel 0 */
+	enum asus_primeb550plus_hwmon_field_list const *fields;
+	size_t nr_fields;
+	unsigned long kinds;	/* BIT() of supported asus_primeb550plus_hwmon_attr_kind */
+	u32 attrs[ASUS_B550PLUS_HWMON_ATTR_KIND_MAX];	/* hwmon attribute of each supported kind */
+	const char *metric;	/* OpenMetrics family, ends with its unit */
+	const char *unit;
+	const char *help;
+	bool milli;		/* hwmon values are thousandths of unit */
 };
 
-#undef ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL
-#undef ASUS_B550PLUS_HWMON_FIELD_TEMP9BIT
-#undef ASUS_B550PLUS_HWMON_FIELD_TEMP8BIT
-#undef ASUS_B550PLUS_HWMON_FIELD_TEMP9BIT
-#undef ASUS_B550PLUS_HWMON_FIELD_TEMP14BIT
-#undef ASUS_B550PLUS_HWMON_FIELD_PWM16
+static const struct asus_primeb550plus_hwmon_type_desc asus_primeb550plus_hwmon_type_descs[] = {
+	{
+		.type = hwmon_in,
+		.name = "in",
+		.index_base = 0,
+		.fields = asus_primeb550plus_hwmon_in_fields,
+		.nr_fields = ARRAY_SIZE(asus_primeb550plus_hwmon_in_fields),
+		.kinds = ASUS_B550PLUS_HWMON_BASE_KINDS | BIT(ASUS_B550PLUS_HWMON_ATTR_LOWEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_HIGHEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_AVERAGE) | BIT(ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY),
+		.attrs = {
+			[ ASUS_B550PLUS_HWMON_ATTR_INPUT ] = hwmon_in_input,
+			[ ASUS_B550PLUS_HWMON_ATTR_LABEL ] = hwmon_in_label,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN ] = hwmon_in_min,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX ] = hwmon_in_max,
+			[ ASUS_B550PLUS_HWMON_ATTR_CRIT ] = hwmon_in_crit,
+			[ ASUS_B550PLUS_HWMON_ATTR_ALARM ] = hwmon_in_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM ] = hwmon_in_min_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM ] = hwmon_in_max_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM ] = hwmon_in_crit_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_LOWEST ] = hwmon_in_lowest,
+			[ ASUS_B550PLUS_HWMON_ATTR_HIGHEST ] = hwmon_in_highest,
+			[ ASUS_B550PLUS_HWMON_ATTR_AVERAGE ] = hwmon_in_average,
+			[ ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY ] = hwmon_in_reset_history,
+		},
+		.metric = "asus_primeb550plus_hwmon_voltage_volts",
+		.unit = "volts",
+		.help = "Voltage input",
+		.milli = true,
+	},
+	{
+		.type = hwmon_temp,
+		.name = "temp",
+		.index_base = 1,
+		.fields = asus_primeb550plus_hwmon_temp_fields,
+		.nr_fields = ARRAY_SIZE(asus_primeb550plus_hwmon_temp_fields),
+		.kinds = ASUS_B550PLUS_HWMON_BASE_KINDS | BIT(ASUS_B550PLUS_HWMON_ATTR_LOWEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_HIGHEST) | BIT(ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY),
+		.attrs = {
+			[ ASUS_B550PLUS_HWMON_ATTR_INPUT ] = hwmon_temp_input,
+			[ ASUS_B550PLUS_HWMON_ATTR_LABEL ] = hwmon_temp_label,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN ] = hwmon_temp_min,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX ] = hwmon_temp_max,
+			[ ASUS_B550PLUS_HWMON_ATTR_CRIT ] = hwmon_temp_crit,
+			[ ASUS_B550PLUS_HWMON_ATTR_ALARM ] = hwmon_temp_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM ] = hwmon_temp_min_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM ] = hwmon_temp_max_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM ] = hwmon_temp_crit_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_LOWEST ] = hwmon_temp_lowest,
+			[ ASUS_B550PLUS_HWMON_ATTR_HIGHEST ] = hwmon_temp_highest,
+			[ ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY ] = hwmon_temp_reset_history,
+		},
+		.metric = "asus_primeb550plus_hwmon_temperature_celsius",
+		.unit = "celsius",
+		.help = "Temperature input",
+		.milli = true,
+	},
+	{
+		.type = hwmon_fan,
+		.name = "fan",
+		.index_base = 1,
+		.fields = asus_primeb550plus_hwmon_fan_fields,
+		.nr_fields = ARRAY_SIZE(asus_primeb550plus_hwmon_fan_fields),
+		.kinds = ASUS_B550PLUS_HWMON_BASE_KINDS & ~(BIT(ASUS_B550PLUS_HWMON_ATTR_CRIT) | BIT(ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM)),
+		.attrs = {
+			[ ASUS_B550PLUS_HWMON_ATTR_INPUT ] = hwmon_fan_input,
+			[ ASUS_B550PLUS_HWMON_ATTR_LABEL ] = hwmon_fan_label,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN ] = hwmon_fan_min,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX ] = hwmon_fan_max,
+			[ ASUS_B550PLUS_HWMON_ATTR_ALARM ] = hwmon_fan_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM ] = hwmon_fan_min_alarm,
+			[ ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM ] = hwmon_fan_max_alarm,
+		},
+		.metric = "asus_primeb550plus_hwmon_fan_rpm",
+		.unit = "rpm",
+		.help = "Fan speed",
+	},
+};
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_uchar_mul_show(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, char *buf)
+static const struct asus_primeb550plus_hwmon_type_desc *asus_primeb550plus_hwmon_type_desc_get(enum hwmon_sensor_types type)
 {
-	unsigned char raw_in;
-	struct asus_primeb550plus_hwmon_data_type_uchar_mul const * const field = &chip_field->data_address.uchar_mul;
+	size_t i;
 
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->bank_no, field->index_in_bank, &raw_in))
-		return -1;
+	for (i=0 ; i<ARRAY_SIZE(asus_primeb550plus_hwmon_type_descs) ; i++)
+		if (asus_primeb550plus_hwmon_type_descs[i].type == type)
+			return &asus_primeb550plus_hwmon_type_descs[i];
 
-	return scnprintf(buf, PAGE_SIZE, "%u\n", raw_in * field->multiplier);
+	return NULL;
 }
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_temp_9bit_show(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, char *buf)
+/* Returns the index in asus_primeb550plus_hwmon_chip_fields of an hwmon channel, or a negative errno */
+static int asus_primeb550plus_hwmon_field_index(enum hwmon_sensor_types type, int channel)
 {
-	unsigned char raw_in_int, raw_in_frac;
-	signed char corrected_in_int;
-	int fractional_value;
-	struct asus_primeb550plus_hwmon_data_type_temp_9bit const * const field = &chip_field->data_address.temp_9bit;
-
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->int_bank_no, field->int_index_in_bank, &raw_in_int))
-		return -1;
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->frac_bank_no, field->frac_index_in_bank, &raw_in_frac))
-		return -1;
+	const struct asus_primeb550plus_hwmon_type_desc *desc = asus_primeb550plus_hwmon_type_desc_get(type);
 
-	corrected_in_int = raw_in_int;
-	fractional_value = corrected_in_int >= 0 ? 500 : -500;
+	if (!desc)
+		return -EOPNOTSUPP;
+	if (channel < 0 || channel >= desc->nr_fields)
+		return -EINVAL;
 
-	return scnprintf(buf, PAGE_SIZE, "%i\n", corrected_in_int * 1000 + !!(raw_in_frac & 0x80) * fractional_value);
+	return desc->fields[channel];
 }
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_temp_8bit_show(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, char *buf)
+/* Returns the asus_primeb550plus_hwmon_attr_kind of an hwmon attribute, or a negative errno */
+static int asus_primeb550plus_hwmon_attr_kind(const struct asus_primeb550plus_hwmon_type_desc *desc, u32 attr)
 {
-	unsigned char raw_in;
-	signed char corrected_in;
-	struct asus_primeb550plus_hwmon_data_type_temp_8bit const * const field = &chip_field->data_address.temp_8bit;
+	unsigned int kind;
 
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->bank_no, field->index_in_bank, &raw_in))
-		return -1;
+	for_each_set_bit(kind, &desc->kinds, ASUS_B550PLUS_HWMON_ATTR_KIND_MAX)
+		if (desc->attrs[kind] == attr)
+			return kind;
 
-	corrected_in = raw_in;
-
-	return scnprintf(buf, PAGE_SIZE, "%i\n", corrected_in * 1000);
+	return -EOPNOTSUPP;
 }
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_temp_14bit_show(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, char *buf)
+/* Finds the hwmon sensor type and channel of a field */
+static const struct asus_primeb550plus_hwmon_type_desc *asus_primeb550plus_hwmon_field_channel(size_t field_index, int *channel)
 {
-	unsigned char raw_int_in, raw_frac_in;
-	struct asus_primeb550plus_hwmon_data_type_temp_14bit const * const field = &chip_field->data_address.temp_14bit;
+	size_t i, j;
+
+	for (i=0 ; i<ARRAY_SIZE(asus_primeb550plus_hwmon_type_descs) ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc = &asus_primeb550plus_hwmon_type_descs[i];
 
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->int_bank_no, field->int_idx, &raw_int_in))
-		return -1;
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->frac_bank_no, field->frac_idx, &raw_frac_in))
-		return -1;
+		for (j=0 ; j<desc->nr_fields ; j++) {
+			if (desc->fields[j] == field_index) {
+				*channel = j;
+				return desc;
+			}
+		}
+	}
 
-	return scnprintf(buf, PAGE_SIZE, "%i\n", raw_int_in * 1000 + (raw_frac_in >> 2));
+	return NULL;
 }
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_pwm16_show(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, char *buf)
+static int asus_primeb550plus_hwmon_rhwm_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
 {
-	unsigned char raw_high, raw_low;
-	struct asus_primeb550plus_hwmon_data_type_pwm16 const * const field = &chip_field->data_address.pwm16;
+	unsigned char a_buf[2] = { bank, index };
+	union acpi_object buf_args = {
+		.type = ACPI_TYPE_BUFFER,
+		.buffer = {
+			.type = ACPI_TYPE_BUFFER,
+			.length = 2,
+			.pointer = a_buf,
+		},
+	};
+	struct acpi_object_list acpi_args = {
+		.count = 1,
+		.pointer = &buf_args,
+	};
+	unsigned long long val;
+	acpi_status a_r;
 
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->high_bank_no, field->high_idx, &raw_high))
-		return -1;
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, field->low_bank_no, field->low_idx, &raw_low))
-		return -1;
+	a_r = acpi_evaluate_integer(devdri_data->rhwm_method, NULL, &acpi_args, &val);
+	if (!ACPI_SUCCESS(a_r))
+		return -EIO;
+	
+	if (val > U8_MAX)
+		return -ERANGE;
 
-	return scnprintf(buf, PAGE_SIZE, "%u\n", (raw_high << 8) + raw_low);
+	*dest = val;
+	return 0;
 }
 
-static const struct asus_primeb550plus_hwmon_chip_field * const asus_primeb550plus_hwmon_chip_field_from_dev_attr(struct device_attribute const * const attr)
-{
-	struct sensor_device_attribute const * const s_dev_attr = to_sensor_dev_attr(attr);
+static const struct asus_primeb550plus_hwmon_backend_ops asus_primeb550plus_hwmon_rhwm_backend = {
+	.name = "rhwm",
+	.read_u8 = asus_primeb550plus_hwmon_rhwm_read_u8,
+};
 
-	if (!s_dev_attr)
-		return NULL;
+static unsigned int adaptive_max_interval = ASUS_B550PLUS_HWMON_ADAPTIVE_MAX_INTERVAL_DEFAULT;
+module_param(adaptive_max_interval, uint, 0644);
+MODULE_PARM_DESC(adaptive_max_interval, "Longest interval (ms) between reads of a steady channel, 0 reads every channel on every sweep");
 
-	return asus_primeb550plus_hwmon_chip_fields[s_dev_attr->index];
-}
+static unsigned long long force_present;
+module_param(force_present, ullong, 0444);
+MODULE_PARM_DESC(force_present, "Bit n set: channel n (driver field order, see asus_primeb550plus_hwmon.h) is connected, without detection");
+
+static unsigned long long force_absent;
+module_param(force_absent, ullong, 0444);
+MODULE_PARM_DESC(force_absent, "Bit n set: hide channel n even if found present");
 
-static ssize_t asus_primeb550plus_hwmon_sysfs_val_show(struct device *dev, struct device_attribute *attr, char *buf)
+static unsigned int presence_recheck = ASUS_B550PLUS_HWMON_PRESENCE_RECHECK_DEFAULT;
+module_param(presence_recheck, uint, 0644);
+MODULE_PARM_DESC(presence_recheck, "Seconds between detection passes over channels not found connected yet, 0 only after probe (and register or replay loads of the emulated instance)");
+
+/* Fields that may ever be present, they get attributes at registration */
+static u64 asus_primeb550plus_hwmon_possible_fields(void)
 {
-	struct asus_primeb550plus_hwmon_chip_field const * const chip_field = asus_primeb550plus_hwmon_chip_field_from_dev_attr(attr);
-	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(dev);
+	return ((ASUS_B550PLUS_HWMON_ALL_FIELDS & ~force_absent) | force_present) & ASUS_B550PLUS_HWMON_ALL_FIELDS;
+}
 
-	if (!chip_field)
-		return -1;
-
-	switch(chip_field->data_type) {
-		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
-			return asus_primeb550plus_hwmon_sysfs_val_uchar_mul_show(devdri_data, chip_field, buf);
-		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
-			return asus_primeb550plus_hwmon_sysfs_val_temp_9bit_show(devdri_data, chip_field, buf);
-		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
-			return asus_primeb550plus_hwmon_sysfs_val_temp_8bit_show(devdri_data, chip_field, buf);
-		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
-			return asus_primeb550plus_hwmon_sysfs_val_temp_14bit_show(devdri_data, chip_field, buf);
-		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
-			return asus_primeb550plus_hwmon_sysfs_val_pwm16_show(devdri_data, chip_field, buf);
-		default:
-			return -1;
-	}
-}
-
-static ssize_t asus_primeb550plus_hwmon_sysfs_label_show(struct device *dev, struct device_attribute *attr, char *buf)
-{
-	struct asus_primeb550plus_hwmon_chip_field const * const chip_field = asus_primeb550plus_hwmon_chip_field_from_dev_attr(attr);
-
-	if (!chip_field)
-		return -1;
-
-	return strscpy(buf, chip_field->label, PAGE_SIZE);
-}
-
-#define ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(_name, _field_index) \
-	static SENSOR_DEVICE_ATTR_RO(_name##_input, asus_primeb550plus_hwmon_sysfs_val, _field_index); \
-	static SENSOR_DEVICE_ATTR_RO(_name##_label, asus_primeb550plus_hwmon_sysfs_label, _field_index) ;
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in0, ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in1, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in2, ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in3, ASUS_B550PLUS_HWMON_FIELD_LIST_3VCC)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in4, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN0)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in5, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN8)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in6, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN4)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in7, ASUS_B550PLUS_HWMON_FIELD_LIST_3VSB)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in8, ASUS_B550PLUS_HWMON_FIELD_LIST_VBAT)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in9, ASUS_B550PLUS_HWMON_FIELD_LIST_VTT)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in10, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN5)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in11, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN6)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in12, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN2)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in13, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN3)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in14, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN7)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(in15, ASUS_B550PLUS_HWMON_FIELD_LIST_VIN9)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp1, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp2, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP2)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp3, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP3)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp4, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP4)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp5, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP5)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp6, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP6)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp7, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_0)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp8, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_1)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp9, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_0)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp10, ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_1)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp11, ASUS_B550PLUS_HWMON_FIELD_LIST_SMIOVT2)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp12, ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp13, ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp14, ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp15, ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp16, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN0)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp17, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN1)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp18, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN2)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(temp19, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN3)
-
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan1, ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan2, ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan3, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN0)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan4, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN1)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan5, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN2)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan6, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN3)
-ASUS_B550PLUS_HWMON_DEVICE_ATTR_RO(fan7, ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4)
-
-
-#define ATTR_REF(_attr_name) &sensor_dev_attr_##_attr_name##_input.dev_attr.attr, &sensor_dev_attr_##_attr_name##_label.dev_attr.attr
-static struct attribute *asus_primeb550plus_hwmon_attrs[] = {
-	ATTR_REF(in0),
-	ATTR_REF(in1),
-	ATTR_REF(in2),
-	ATTR_REF(in3),
-	ATTR_REF(in4),
-	ATTR_REF(in5),
-	ATTR_REF(in6),
-	ATTR_REF(in7),
-	ATTR_REF(in8),
-	ATTR_REF(in9),
-	ATTR_REF(in10),
-	ATTR_REF(in11),
-	ATTR_REF(in12),
-	ATTR_REF(in13),
-	ATTR_REF(in14),
-	ATTR_REF(in15),
-
-	ATTR_REF(temp1),
-	ATTR_REF(temp2),
-	ATTR_REF(temp3),
-	ATTR_REF(temp4),
-	ATTR_REF(temp5),
-	ATTR_REF(temp6),
-
-	ATTR_REF(temp7),
-	ATTR_REF(temp8),
-	ATTR_REF(temp9),
-	ATTR_REF(temp10),
-
-	ATTR_REF(temp11),
-
-	ATTR_REF(temp12),
-	ATTR_REF(temp13),
-
-	ATTR_REF(temp14),
-	ATTR_REF(temp15),
-	ATTR_REF(temp16),
-	ATTR_REF(temp17),
-	ATTR_REF(temp18),
-	ATTR_REF(temp19),
-
-	ATTR_REF(fan1),
-	ATTR_REF(fan2),
-	ATTR_REF(fan3),
-	ATTR_REF(fan4),
-	ATTR_REF(fan5),
-	ATTR_REF(fan6),
-	ATTR_REF(fan7),
+static char *backend = "rhwm";
+module_param(backend, charp, 0444);
+MODULE_PARM_DESC(backend, "Register access: rhwm (ACPI method, default), superio (direct port access) or replay (emulated instance only, serves a raw trace)");
 
-	NULL
+static char *superio_mutex = "\\_SB.PCI0.SBRG.SIO1.MUT0";
+module_param(superio_mutex, charp, 0444);
+MODULE_PARM_DESC(superio_mutex, "ACPI mutex the firmware takes around Super-I/O accesses");
+
+static bool low_wakeup;
+module_param(low_wakeup, bool, 0444);
+MODULE_PARM_DESC(low_wakeup, "Power aware sampling: the sampler never wakes an idle CPU and slows down while nobody reads, readers sweep when values got too old");
+
+static unsigned int sampler_slack = ASUS_B550PLUS_HWMON_SAMPLER_SLACK_DEFAULT;
+module_param(sampler_slack, uint, 0644);
+MODULE_PARM_DESC(sampler_slack, "How late (ms) the sampler may be before a reader has it sweep at once");
+
+static unsigned int max_staleness = ASUS_B550PLUS_HWMON_MAX_STALENESS_DEFAULT;
+module_param(max_staleness, uint, 0644);
+MODULE_PARM_DESC(max_staleness, "How late (ms) the sampler may be before a reader waits for a sweep, 0 never waits");
+
+static unsigned int archive_size = ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_DEFAULT;
+module_param(archive_size, uint, 0444);
+MODULE_PARM_DESC(archive_size, "Memory (KiB, up to 65536) for the compressed history of every sweep, 0 disables it");
+
+static unsigned int breaker_threshold = ASUS_B550PLUS_HWMON_BREAKER_THRESHOLD_DEFAULT;
+module_param(breaker_threshold, uint, 0644);
+MODULE_PARM_DESC(breaker_threshold, "Consecutive read failures after which a bank is left alone for a while, 0 never gives up");
+
+static bool allow_writes;
+module_param(allow_writes, bool, 0444);
+MODULE_PARM_DESC(allow_writes, "Let the fan curve engine write PWM registers of the board chip (superio backend only, the emulated instance always can)");
+
+static unsigned long watchdog_fans = ASUS_B550PLUS_HWMON_WATCHDOG_FANS_DEFAULT;
+module_param(watchdog_fans, ulong, 0644);
+MODULE_PARM_DESC(watchdog_fans, "Bit n set: fann+1 is watched for stalls (sysfan and cpufan by default)");
+
+static unsigned int watchdog_fan_min;
+module_param(watchdog_fan_min, uint, 0644);
+MODULE_PARM_DESC(watchdog_fan_min, "Watched fans below this speed (RPM) are stalled, 0 disables stall detection");
+
+static unsigned long watchdog_temps = ASUS_B550PLUS_HWMON_WATCHDOG_TEMPS_DEFAULT;
+module_param(watchdog_temps, ulong, 0644);
+MODULE_PARM_DESC(watchdog_temps, "Bit n set: tempn+1 is watched for overtemperature (PCH CPU temperature by default)");
+
+static unsigned int watchdog_temp_max;
+module_param(watchdog_temp_max, uint, 0644);
+MODULE_PARM_DESC(watchdog_temp_max, "Watched temperatures above this (m°C) are overtemperature, 0 disables overtemperature detection");
+
+static unsigned int watchdog_debounce = ASUS_B550PLUS_HWMON_WATCHDOG_DEBOUNCE_DEFAULT;
+module_param(watchdog_debounce, uint, 0644);
+MODULE_PARM_DESC(watchdog_debounce, "Sweeps in a row a watched channel must be past its threshold to trip");
+
+static bool watchdog_shutdown;
+module_param(watchdog_shutdown, bool, 0644);
+MODULE_PARM_DESC(watchdog_shutdown, "Power the machine off when the watchdog trips");
+
+/*
+ * Super-I/O backend: hardware monitor registers through the index/data
+ * ports, without the AML interpreter. Firmware uses the same ports, so
+ * every access is done holding its ACPI mutex.
+ */
+#define ASUS_B550PLUS_HWMON_SUPERIO_PORT		0x2e	/* index, data is next */
+#define ASUS_B550PLUS_HWMON_SUPERIO_ENTER		0x87
+#define ASUS_B550PLUS_HWMON_SUPERIO_EXIT		0xaa
+#define ASUS_B550PLUS_HWMON_SUPERIO_REG_LDN		0x07
+#define ASUS_B550PLUS_HWMON_SUPERIO_REG_ENABLE		0x30
+#define ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_HIGH	0x60
+#define ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_LOW	0x61
+#define ASUS_B550PLUS_HWMON_SUPERIO_LDN_HWM		0x0b
+#define ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET		5
+#define ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET		6
+#define ASUS_B550PLUS_HWMON_HWM_REG_BANK		0x4e
+#define ASUS_B550PLUS_HWMON_SUPERIO_MUTEX_TIMEOUT	500	/* ms */
+
+/* Port accessors, so the backend can run against an emulated chip */
+struct asus_primeb550plus_hwmon_port_ops {
+	unsigned char (*inb)(void *ctx, unsigned short port);
+	void (*outb)(void *ctx, unsigned char value, unsigned short port);
 };
-#undef ATTR_REF
-ATTRIBUTE_GROUPS(asus_primeb550plus_hwmon);
 
+struct asus_primeb550plus_hwmon_superio {
+	struct asus_primeb550plus_hwmon_port_ops const *ports;
+	void *ports_ctx;
+	acpi_handle mutex;	/* NULL when nobody else uses the ports */
+	unsigned short hwm_base;
+};
 
-static int asus_primeb550plus_hwmon_check_dmi(void)
+static unsigned char asus_primeb550plus_hwmon_real_inb(void *ctx, unsigned short port)
 {
-	if (dmi_check_system(asus_accepted_dmis))
-		return 0;
-	
-	return -ENODEV;
+	return inb(port);
 }
 
-static int asus_primeb550plus_hwmon_get_method_handles(struct asus_primeb550plus_hwmon_data *devdri_data)
+static void asus_primeb550plus_hwmon_real_outb(void *ctx, unsigned char value, unsigned short port)
 {
-	struct device *dev = &devdri_data->acpi_dev->dev;
-	acpi_handle a_hndl;
-	acpi_status a_status;
-	acpi_object_type a_type;
+	outb(value, port);
+}
 
-	a_status = acpi_get_handle(devdri_data->acpi_dev_handle, "RHWM", &a_hndl);
-	if (ACPI_SUCCESS(a_status)) {
-		devdri_data->rhwm_method = a_hndl;
-	} else {
-		dev_err(dev, "method RHWM not found: %s\n", acpi_format_exception(a_status));
-		return -ENODEV;
-	}
+static const struct asus_primeb550plus_hwmon_port_ops asus_primeb550plus_hwmon_real_ports = {
+	.inb = asus_primeb550plus_hwmon_real_inb,
+	.outb = asus_primeb550plus_hwmon_real_outb,
+};
 
-	a_status = acpi_get_type(devdri_data->rhwm_method, &a_type);
-	if (!ACPI_SUCCESS(a_status)) {
-		dev_err(dev, "Could not figure out acpi object type: %s\n", acpi_format_exception(a_status));
-		return -EIO;
-	}
-	if (a_type != ACPI_TYPE_METHOD) {
-		dev_err(dev, "RHWM found, but is not a method\n");
-		return -ENODEV;
-	}
+static int asus_primeb550plus_hwmon_superio_lock(struct asus_primeb550plus_hwmon_superio *superio)
+{
+	if (superio->mutex && !ACPI_SUCCESS(acpi_acquire_mutex(superio->mutex, NULL, ASUS_B550PLUS_HWMON_SUPERIO_MUTEX_TIMEOUT)))
+		return -ETIMEDOUT;
 
 	return 0;
 }
 
-struct asus_primeb550plus_hwmon_supported_superio {
-	unsigned char vendor_id_high;
-	unsigned char chip_id;
-};
+static void asus_primeb550plus_hwmon_superio_unlock(struct asus_primeb550plus_hwmon_superio *superio)
+{
+	if (superio->mutex)
+		acpi_release_mutex(superio->mutex, NULL);
+}
 
-static const struct asus_primeb550plus_hwmon_supported_superio asus_primeb550plus_hwmon_supported_superios[] = {
-	{ .vendor_id_high = 0x5c, .chip_id = 0xc1 },
-};
+static unsigned char asus_primeb550plus_hwmon_superio_cfg_read(struct asus_primeb550plus_hwmon_superio *superio, unsigned char reg)
+{
+	superio->ports->outb(superio->ports_ctx, reg, ASUS_B550PLUS_HWMON_SUPERIO_PORT);
+	return superio->ports->inb(superio->ports_ctx, ASUS_B550PLUS_HWMON_SUPERIO_PORT + 1);
+}
 
-static int asus_primeb550plus_hwmon_check_chip(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+static void asus_primeb550plus_hwmon_superio_cfg_write(struct asus_primeb550plus_hwmon_superio *superio, unsigned char reg, unsigned char value)
 {
-	size_t i;
-	unsigned char vendor_id_high, chip_id;
+	superio->ports->outb(superio->ports_ctx, reg, ASUS_B550PLUS_HWMON_SUPERIO_PORT);
+	superio->ports->outb(superio->ports_ctx, value, ASUS_B550PLUS_HWMON_SUPERIO_PORT + 1);
+}
 
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, 0, 0x4f, &vendor_id_high))
-		goto err_read;
-	if (asus_primeb550plus_hwmon_read_u8(devdri_data, 0, 0x58, &chip_id))
-		goto err_read;
+static int asus_primeb550plus_hwmon_superio_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
+{
+	struct asus_primeb550plus_hwmon_superio * const superio = devdri_data->backend_data;
+	unsigned short const index_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET;
+	unsigned short const data_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET;
+	int err;
 
-	for (i=0 ; i<sizeof(asus_primeb550plus_hwmon_supported_superios)/sizeof(asus_primeb550plus_hwmon_supported_superios[0]) ; i++) {
-		struct asus_primeb550plus_hwmon_supported_superio const * const chip = &asus_primeb550plus_hwmon_supported_superios[i];
+	if ((err = asus_primeb550plus_hwmon_superio_lock(superio)))
+		return err;
 
-		if (vendor_id_high == chip->vendor_id_high && chip_id == chip->chip_id) {
-			dev_info(dev, "Found chip vendor_id=0x%02x, chip_id=0x%02x\n", vendor_id_high , chip_id);
-			return 0;
-		}
-	}
+	/* Firmware may have switched banks since we last held the mutex */
+	superio->ports->outb(superio->ports_ctx, ASUS_B550PLUS_HWMON_HWM_REG_BANK, index_port);
+	superio->ports->outb(superio->ports_ctx, bank, data_port);
+	superio->ports->outb(superio->ports_ctx, index, index_port);
+	*dest = superio->ports->inb(superio->ports_ctx, data_port);
 
-	dev_info(dev, "Unknown chip vendor_id=0x%02x, chip_id=0x%02x\n", vendor_id_high, chip_id);
-	return 1;
+	asus_primeb550plus_hwmon_superio_unlock(superio);
 
-err_read:
-	dev_info(dev, "Error while reading vendor/chip id\n");
-	return 1;
+	return 0;
 }
 
-static int asus_primeb550plus_hwmon_add(struct acpi_device *device)
+/* Single bank selection and mutex hold for the whole block */
+static int asus_primeb550plus_hwmon_superio_read_block(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char const *indexes, size_t count, unsigned char *dest)
 {
+	struct asus_primeb550plus_hwmon_superio * const superio = devdri_data->backend_data;
+	unsigned short const index_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET;
+	unsigned short const data_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET;
+	size_t i;
 	int err;
-	struct asus_primeb550plus_hwmon_data *devdri_data;
 
-	if ((err = asus_primeb550plus_hwmon_check_dmi())) {
-		dev_info(&device->dev, "Unsupported system DMI\n");
-		goto out;
-	}
+	if ((err = asus_primeb550plus_hwmon_superio_lock(superio)))
+		return err;
 
-	if (strcmp("ASUSWMI", acpi_device_uid(device))) {
-		err = -ENODEV;
-		dev_info(&device->dev, "Unsupported device uid\n");
-		goto out;
+	superio->ports->outb(superio->ports_ctx, ASUS_B550PLUS_HWMON_HWM_REG_BANK, index_port);
+	superio->ports->outb(superio->ports_ctx, bank, data_port);
+	for (i=0 ; i<count ; i++) {
+		superio->ports->outb(superio->ports_ctx, indexes[i], index_port);
+		dest[i] = superio->ports->inb(superio->ports_ctx, data_port);
 	}
 
-	devdri_data = devm_kzalloc(&device->dev, sizeof(*devdri_data), GFP_KERNEL);
-	if (!devdri_data) {
-		err =  -ENOMEM;
-		goto out;
-	}
+	asus_primeb550plus_hwmon_superio_unlock(superio);
 
-	devdri_data->acpi_dev = device;
-	devdri_data->acpi_dev_handle = device->handle;
+	return 0;
+}
 
-	if ((err = asus_primeb550plus_hwmon_get_method_handles(devdri_data)))
-		goto out;
+static int asus_primeb550plus_hwmon_superio_write_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value)
+{
+	struct asus_primeb550plus_hwmon_superio * const superio = devdri_data->backend_data;
+	unsigned short const index_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET;
+	unsigned short const data_port = superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET;
+	int err;
 
-	if ((err = asus_primeb550plus_hwmon_check_chip(&device->dev, devdri_data)))
-		goto out;
+	if ((err = asus_primeb550plus_hwmon_superio_lock(superio)))
+		return err;
 
-	dev_set_drvdata(&device->dev, devdri_data);
+	superio->ports->outb(superio->ports_ctx, ASUS_B550PLUS_HWMON_HWM_REG_BANK, index_port);
+	superio->ports->outb(superio->ports_ctx, bank, data_port);
+	superio->ports->outb(superio->ports_ctx, index, index_port);
+	superio->ports->outb(superio->ports_ctx, value, data_port);
 
-	devdri_data->device = devm_hwmon_device_register_with_groups(&device->dev, "asus_primeb550plus_hwmon", devdri_data, asus_primeb550plus_hwmon_groups);
-	err = PTR_ERR_OR_ZERO(devdri_data->device);
+	asus_primeb550plus_hwmon_superio_unlock(superio);
 
-out:
-	return err;
+	return 0;
 }
 
-static struct acpi_driver asus_primeb550plus_hwmon_driver = {
-	.name = "asus-primeb550plus-hwmon",
-	.class = "hwmon",
-	.ids = asus_primeb550plus_hwmon_acpi_ids,
-	.ops = {
-		.add = asus_primeb550plus_hwmon_add,
-	},
+static const struct asus_primeb550plus_hwmon_backend_ops asus_primeb550plus_hwmon_superio_backend = {
+	.name = "superio",
+	.read_u8 = asus_primeb550plus_hwmon_superio_read_u8,
+	.read_block = asus_primeb550plus_hwmon_superio_read_block,
+	.write_u8 = asus_primeb550plus_hwmon_superio_write_u8,
 };
 
-module_acpi_driver(asus_primeb550plus_hwmon_driver)
+/*
+ * Finds the hardware monitor base address from the Super-I/O config
+ * space. With real ports, the firmware mutex is looked up, the config
+ * ports reserved while in use and the index/data ports for the lifetime
+ * of the device.
+ */
+static int asus_primeb550plus_hwmon_superio_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_port_ops const *ports, void *ports_ctx)
+{
+	struct asus_primeb550plus_hwmon_superio *superio;
+	bool const real = ports == &asus_primeb550plus_hwmon_real_ports;
+	unsigned char enabled;
+	acpi_status a_status;
+	int err;
+
+	superio = devm_kzalloc(dev, sizeof(*superio), GFP_KERNEL);
+	if (!superio)
+		return -ENOMEM;
+
+	superio->ports = ports;
+	superio->ports_ctx = ports_ctx;
+
+	if (real) {
+		a_status = acpi_get_handle(NULL, superio_mutex, &superio->mutex);
+		if (!ACPI_SUCCESS(a_status)) {
+			dev_err(dev, "ACPI mutex %s not found: %s\n", superio_mutex, acpi_format_exception(a_status));
+			return -ENODEV;
+		}
+	}
+
+	if ((err = asus_primeb550plus_hwmon_superio_lock(superio)))
+		return err;
+
+	if (real && !request_muxed_region(ASUS_B550PLUS_HWMON_SUPERIO_PORT, 2, "asus_primeb550plus_hwmon")) {
+		asus_primeb550plus_hwmon_superio_unlock(superio);
+		return -EBUSY;
+	}
+
+	ports->outb(ports_ctx, ASUS_B550PLUS_HWMON_SUPERIO_ENTER, ASUS_B550PLUS_HWMON_SUPERIO_PORT);
+	ports->outb(ports_ctx, ASUS_B550PLUS_HWMON_SUPERIO_ENTER, ASUS_B550PLUS_HWMON_SUPERIO_PORT);
+	asus_primeb550plus_hwmon_superio_cfg_write(superio, ASUS_B550PLUS_HWMON_SUPERIO_REG_LDN, ASUS_B550PLUS_HWMON_SUPERIO_LDN_HWM);
+	enabled = asus_primeb550plus_hwmon_superio_cfg_read(superio, ASUS_B550PLUS_HWMON_SUPERIO_REG_ENABLE) & 0x01;
+	superio->hwm_base = asus_primeb550plus_hwmon_superio_cfg_read(superio, ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_HIGH) << 8;
+	superio->hwm_base |= asus_primeb550plus_hwmon_superio_cfg_read(superio, ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_LOW);
+	ports->outb(ports_ctx, ASUS_B550PLUS_HWMON_SUPERIO_EXIT, ASUS_B550PLUS_HWMON_SUPERIO_PORT);
+
+	if (real)
+		release_region(ASUS_B550PLUS_HWMON_SUPERIO_PORT, 2);
+	asus_primeb550plus_hwmon_superio_unlock(superio);
+
+	/* Low bits are forced to 0 by the chip, 0 or all ones means no decoding */
+	superio->hwm_base &= ~0x7;
+	if (!enabled || !superio->hwm_base || superio->hwm_base == 0xfff8) {
+		dev_err(dev, "Hardware monitor logical device disabled\n");
+		return -ENODEV;
+	}
+
+	/* Index and data ports, accessed without the config space dance */
+	if (real && !devm_request_region(dev, superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET, 2, "asus_primeb550plus_hwmon")) {
+		dev_err(dev, "Super-I/O ports at 0x%04x busy\n", superio->hwm_base + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET);
+		return -EBUSY;
+	}
+
+	dev_info(dev, "Using Super-I/O ports at 0x%04x\n", superio->hwm_base);
+
+	devdri_data->backend = &asus_primeb550plus_hwmon_superio_backend;
+	devdri_data->backend_data = superio;
+	return 0;
+}
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+/*
+ * Register file in memory, so that the driver can be run without the
+ * board. Registers are set through debugfs.
+ */
+#define ASUS_B550PLUS_HWMON_EMULATED_BANKS 16
+
+struct asus_primeb550plus_hwmon_emulated {
+	unsigned char regs[ASUS_B550PLUS_HWMON_EMULATED_BANKS][256];
+
+	/* Port state, superio backend only (serialized by update_lock) */
+	bool sio_entered;
+	unsigned int sio_enter_count;
+	unsigned char sio_index;
+	unsigned char sio_ldn;
+	unsigned char hwm_index;
+	unsigned char hwm_bank;
+
+	/* Replay backend, protected by update_lock */
+	unsigned char replay_buf[sizeof(struct asus_primeb550plus_hwmon_raw_trace_header) + ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS * sizeof(struct asus_primeb550plus_hwmon_raw_record)];
+	size_t replay_len;
+	unsigned int nr_replay;		/* records, 0 until a whole valid trace is written */
+	unsigned int replay_cursor;
+};
+
+static int asus_primeb550plus_hwmon_emulated_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
+{
+	struct asus_primeb550plus_hwmon_emulated const * const emulated = devdri_data->backend_data;
+
+	if (bank >= ASUS_B550PLUS_HWMON_EMULATED_BANKS)
+		return -EIO;
+
+	*dest = READ_ONCE(emulated->regs[bank][index]);
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_emulated_write_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value)
+{
+	struct asus_primeb550plus_hwmon_emulated * const emulated = devdri_data->backend_data;
+
+	if (bank >= ASUS_B550PLUS_HWMON_EMULATED_BANKS)
+		return -EIO;
+
+	WRITE_ONCE(emulated->regs[bank][index], value);
+	return 0;
+}
+
+static const struct asus_primeb550plus_hwmon_backend_ops asus_primeb550plus_hwmon_emulated_backend = {
+	.name = "emulated",
+	.read_u8 = asus_primeb550plus_hwmon_emulated_read_u8,
+	.write_u8 = asus_primeb550plus_hwmon_emulated_write_u8,
+};
+
+/* Port level model of the chip over the same register file, for the superio backend */
+#define ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE 0x290
+
+static unsigned char asus_primeb550plus_hwmon_emulated_inb(void *ctx, unsigned short port)
+{
+	struct asus_primeb550plus_hwmon_emulated * const emulated = ctx;
+
+	if (port == ASUS_B550PLUS_HWMON_SUPERIO_PORT + 1 && emulated->sio_entered) {
+		if (emulated->sio_index == ASUS_B550PLUS_HWMON_SUPERIO_REG_LDN)
+			return emulated->sio_ldn;
+		if (emulated->sio_ldn != ASUS_B550PLUS_HWMON_SUPERIO_LDN_HWM)
+			return 0xff;
+
+		switch(emulated->sio_index) {
+			case ASUS_B550PLUS_HWMON_SUPERIO_REG_ENABLE:
+				return 0x01;
+			case ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_HIGH:
+				return ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE >> 8;
+			case ASUS_B550PLUS_HWMON_SUPERIO_REG_BASE_LOW:
+				return ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE & 0xff;
+			default:
+				return 0xff;
+		}
+	}
+
+	if (port == ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE + ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET) {
+		if (emulated->hwm_index == ASUS_B550PLUS_HWMON_HWM_REG_BANK)
+			return emulated->hwm_bank;
+		return READ_ONCE(emulated->regs[emulated->hwm_bank][emulated->hwm_index]);
+	}
+
+	return 0xff;
+}
+
+static void asus_primeb550plus_hwmon_emulated_outb(void *ctx, unsigned char value, unsigned short port)
+{
+	struct asus_primeb550plus_hwmon_emulated * const emulated = ctx;
+
+	switch(port) {
+		case ASUS_B550PLUS_HWMON_SUPERIO_PORT:
+			if (value == ASUS_B550PLUS_HWMON_SUPERIO_EXIT) {
+				emulated->sio_entered = false;
+				emulated->sio_enter_count = 0;
+			} else if (!emulated->sio_entered) {
+				if (value == ASUS_B550PLUS_HWMON_SUPERIO_ENTER && ++emulated->sio_enter_count == 2)
+					emulated->sio_entered = true;
+			} else {
+				emulated->sio_index = value;
+			}
+			break;
+		case ASUS_B550PLUS_HWMON_SUPERIO_PORT + 1:
+			if (emulated->sio_entered && emulated->sio_index == ASUS_B550PLUS_HWMON_SUPERIO_REG_LDN)
+				emulated->sio_ldn = value;
+			break;
+		case ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE + ASUS_B550PLUS_HWMON_HWM_INDEX_OFFSET:
+			emulated->hwm_index = value;
+			break;
+		case ASUS_B550PLUS_HWMON_EMULATED_HWM_BASE + ASUS_B550PLUS_HWMON_HWM_DATA_OFFSET:
+			if (emulated->hwm_index == ASUS_B550PLUS_HWMON_HWM_REG_BANK)
+				emulated->hwm_bank = value % ASUS_B550PLUS_HWMON_EMULATED_BANKS;
+			else
+				WRITE_ONCE(emulated->regs[emulated->hwm_bank][emulated->hwm_index], value);
+			break;
+	}
+}
+
+static const struct asus_primeb550plus_hwmon_port_ops asus_primeb550plus_hwmon_emulated_ports = {
+	.inb = asus_primeb550plus_hwmon_emulated_inb,
+	.outb = asus_primeb550plus_hwmon_emulated_outb,
+};
+
+/*
+ * Replay backend: serves a register from the next record reading it in
+ * the loaded trace (wrapping around), so a recorded sequence of values
+ * is played back in order. Registers the trace does not have come from
+ * the register file.
+ */
+static int asus_primeb550plus_hwmon_replay_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
+{
+	struct asus_primeb550plus_hwmon_emulated * const emulated = devdri_data->backend_data;
+	struct asus_primeb550plus_hwmon_raw_record const * const records = (void *)(emulated->replay_buf + sizeof(struct asus_primeb550plus_hwmon_raw_trace_header));
+	unsigned int i;
+
+	for (i=0 ; i<emulated->nr_replay ; i++) {
+		unsigned int const n = (emulated->replay_cursor + i) % emulated->nr_replay;
+
+		if (records[n].bank != bank || records[n].index != index)
+			continue;
+
+		emulated->replay_cursor = n + 1;
+		if (records[n].flags & ASUS_PRIMEB550PLUS_HWMON_RAW_RECORD_ERROR)
+			return -EIO;
+		*dest = records[n].value;
+		return 0;
+	}
+
+	return asus_primeb550plus_hwmon_emulated_read_u8(devdri_data, bank, index, dest);
+}
+
+/* Writes land in the register file, so curves can be run against a recorded trace */
+static const struct asus_primeb550plus_hwmon_backend_ops asus_primeb550plus_hwmon_replay_backend = {
+	.name = "replay",
+	.read_u8 = asus_primeb550plus_hwmon_replay_read_u8,
+	.write_u8 = asus_primeb550plus_hwmon_emulated_write_u8,
+};
+#endif
+
+static void asus_primeb550plus_hwmon_account(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value, int err, u64 duration)
+{
+	struct asus_primeb550plus_hwmon_backend_stats *stats;
+
+	stats = get_cpu_ptr(devdri_data->backend_stats);
+	stats->calls++;
+	if (err)
+		stats->errors++;
+	if (bank < ASUS_B550PLUS_HWMON_LATENCY_BANKS)
+		stats->latency[bank][min_t(unsigned int, fls64(duration), ASUS_B550PLUS_HWMON_LATENCY_BUCKETS - 1)]++;
+	put_cpu_ptr(devdri_data->backend_stats);
+
+	trace_asus_primeb550plus_hwmon_read_u8(devdri_data->backend->name, bank, index, value, err, duration);
+
+	if (devdri_data->raw_trace.enabled) {
+		struct asus_primeb550plus_hwmon_raw_record * const record = &devdri_data->raw_trace.records[devdri_data->raw_trace.head++ % ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS];
+
+		record->time_ns = ktime_get_ns() - devdri_data->raw_trace.start_ns;
+		record->bank = bank;
+		record->index = index;
+		record->value = value;
+		record->flags = err ? ASUS_PRIMEB550PLUS_HWMON_RAW_RECORD_ERROR : 0;
+		record->reserved = 0;
+	}
+}
+
+/* Must be called with update_lock held */
+static int asus_primeb550plus_hwmon_breaker_check(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank)
+{
+	struct asus_primeb550plus_hwmon_breaker *breaker;
+
+	if (bank >= ASUS_B550PLUS_HWMON_BREAKER_BANKS)
+		return 0;
+
+	breaker = &devdri_data->breakers[bank];
+	if (!breaker->backoff || !time_before(jiffies, breaker->retry_at))
+		return 0;
+
+	breaker->rejected++;
+	return -EBUSY;
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_breaker_account(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, int err)
+{
+	unsigned int const threshold = READ_ONCE(breaker_threshold);
+	struct asus_primeb550plus_hwmon_breaker *breaker;
+
+	if (bank >= ASUS_B550PLUS_HWMON_BREAKER_BANKS)
+		return;
+
+	breaker = &devdri_data->breakers[bank];
+	if (!err) {
+		breaker->failures = 0;
+		breaker->backoff = 0;
+		return;
+	}
+
+	breaker->errors++;
+	if (breaker->backoff) {
+		breaker->backoff = min_t(unsigned int, 2 * breaker->backoff, ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MAX);
+	} else if (threshold && ++breaker->failures >= threshold) {
+		breaker->backoff = ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MIN;
+		breaker->trips++;
+	} else {
+		return;
+	}
+	breaker->retry_at = jiffies + msecs_to_jiffies(breaker->backoff);
+}
+
+static int asus_primeb550plus_hwmon_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
+{
+	u64 start;
+	int err;
+
+	if ((err = asus_primeb550plus_hwmon_breaker_check(devdri_data, bank)))
+		return err;
+
+	start = ktime_get_ns();
+	err = devdri_data->backend->read_u8(devdri_data, bank, index, dest);
+	asus_primeb550plus_hwmon_account(devdri_data, bank, index, err ? 0 : *dest, err, ktime_get_ns() - start);
+	asus_primeb550plus_hwmon_breaker_account(devdri_data, bank, err);
+
+	return err;
+}
+
+/*
+ * Registers of a block are accounted (and traced) one by one, each with
+ * its share of the block duration.
+ */
+static int asus_primeb550plus_hwmon_read_block(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char const *indexes, size_t count, unsigned char *dest)
+{
+	u64 start, duration;
+	size_t i;
+	int err;
+
+	if (!devdri_data->backend->read_block) {
+		for (i=0 ; i<count ; i++)
+			if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, bank, indexes[i], &dest[i])))
+				return err;
+		return 0;
+	}
+
+	if ((err = asus_primeb550plus_hwmon_breaker_check(devdri_data, bank)))
+		return err;
+
+	start = ktime_get_ns();
+	err = devdri_data->backend->read_block(devdri_data, bank, indexes, count, dest);
+	duration = div_u64(ktime_get_ns() - start, count);
+
+	for (i=0 ; i<count ; i++)
+		asus_primeb550plus_hwmon_account(devdri_data, bank, indexes[i], err ? 0 : dest[i], err, duration);
+	asus_primeb550plus_hwmon_breaker_account(devdri_data, bank, err);
+
+	return err;
+}
+
+/* Only the fan curve engine writes, must be called with update_lock held */
+static int asus_primeb550plus_hwmon_write_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value)
+{
+	int err;
+
+	if (!devdri_data->writable)
+		return -EPERM;
+
+	err = devdri_data->backend->write_u8(devdri_data, bank, index, value);
+	devdri_data->chip_writes++;
+	if (err)
+		devdri_data->chip_write_errors++;
+
+	return err;
+}
+
+static u64 asus_primeb550plus_hwmon_backend_calls(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	u64 calls = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		calls += per_cpu_ptr(devdri_data->backend_stats, cpu)->calls;
+
+	return calls;
+}
+
+/*
+ * Reads a value spread over two registers. The chip may update it between
+ * both accesses, so the high byte is read again after the low one and the
+ * whole read is retried (a bounded number of times) if it changed.
+ */
+static int asus_primeb550plus_hwmon_read_u8_pair(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char high_bank, unsigned char high_index, unsigned char low_bank, unsigned char low_index, unsigned char *high, unsigned char *low)
+{
+	unsigned char raw_high, raw_low, raw_high_again;
+	int retries, err;
+
+	if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, high_bank, high_index, &raw_high)))
+		return err;
+
+	for (retries=0 ; ; retries++) {
+		if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, low_bank, low_index, &raw_low)))
+			return err;
+		if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, high_bank, high_index, &raw_high_again)))
+			return err;
+
+		if (raw_high_again == raw_high)
+			break;
+
+		if (retries == ASUS_B550PLUS_HWMON_PAIRED_READ_RETRIES) {
+			devdri_data->paired_read_failures++;
+			return -EAGAIN;
+		}
+
+		devdri_data->paired_read_retries++;
+		raw_high = raw_high_again;
+	}
+
+	*high = raw_high;
+	*low = raw_low;
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_read_field(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_chip_field const * const chip_field, long *val)
+{
+	unsigned char banks[2], indexes[2], raw[2];
+	int err;
+
+	if (asus_primeb550plus_hwmon_field_registers(chip_field, banks, indexes) == 1) {
+		if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, banks[0], indexes[0], &raw[0])))
+			return err;
+	} else if ((err = asus_primeb550plus_hwmon_read_u8_pair(devdri_data, banks[0], indexes[0], banks[1], indexes[1], &raw[0], &raw[1]))) {
+		return err;
+	}
+
+	*val = asus_primeb550plus_hwmon_decode_field(chip_field, raw);
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_plan_cmp(const void *a, const void *b)
+{
+	return *(const u16 *)a - *(const u16 *)b;
+}
+
+static unsigned int asus_primeb550plus_hwmon_plan_runs(unsigned char const *banks, unsigned int count, struct asus_primeb550plus_hwmon_plan_run *runs)
+{
+	unsigned int nr_runs = 0;
+	unsigned int i;
+
+	for (i=0 ; i<count ; i++) {
+		if (!nr_runs || runs[nr_runs-1].bank != banks[i]) {
+			runs[nr_runs].bank = banks[i];
+			runs[nr_runs].first = i;
+			runs[nr_runs].count = 0;
+			nr_runs++;
+		}
+		runs[nr_runs-1].count++;
+	}
+
+	return nr_runs;
+}
+
+static void asus_primeb550plus_hwmon_plan_init(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct asus_primeb550plus_hwmon_read_plan * const plan = &devdri_data->plan;
+	u16 keys[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	unsigned char verify_banks[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	unsigned int nr_keys = 0;
+	size_t i, j, slot;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		unsigned char banks[2], indexes[2];
+
+		plan->fields[i].nr_regs = asus_primeb550plus_hwmon_field_registers(asus_primeb550plus_hwmon_chip_fields[i], banks, indexes);
+		for (j=0 ; j<plan->fields[i].nr_regs ; j++)
+			keys[nr_keys++] = banks[j] << 8 | indexes[j];
+	}
+
+	sort(keys, nr_keys, sizeof(keys[0]), asus_primeb550plus_hwmon_plan_cmp, NULL);
+
+	plan->nr_slots = 0;
+	for (i=0 ; i<nr_keys ; i++) {
+		if (plan->nr_slots && keys[i] == (plan->banks[plan->nr_slots-1] << 8 | plan->indexes[plan->nr_slots-1]))
+			continue;
+		plan->banks[plan->nr_slots] = keys[i] >> 8;
+		plan->indexes[plan->nr_slots] = keys[i] & 0xff;
+		plan->nr_slots++;
+	}
+	plan->nr_runs = asus_primeb550plus_hwmon_plan_runs(plan->banks, plan->nr_slots, plan->runs);
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		unsigned char banks[2], indexes[2];
+
+		asus_primeb550plus_hwmon_field_registers(asus_primeb550plus_hwmon_chip_fields[i], banks, indexes);
+		for (j=0 ; j<plan->fields[i].nr_regs ; j++)
+			for (slot=0 ; slot<plan->nr_slots ; slot++)
+				if (plan->banks[slot] == banks[j] && plan->indexes[slot] == indexes[j])
+					plan->fields[i].slots[j] = slot;
+	}
+
+	/* Verify slots in slot order, so they are grouped by bank too */
+	plan->nr_verify = 0;
+	for (slot=0 ; slot<plan->nr_slots ; slot++) {
+		bool needed = false;
+
+		for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+			if (plan->fields[i].nr_regs == 2 && plan->fields[i].slots[0] == slot) {
+				plan->fields[i].verify = plan->nr_verify;
+				needed = true;
+			}
+		}
+		if (!needed)
+			continue;
+
+		plan->verify_slots[plan->nr_verify] = slot;
+		plan->verify_indexes[plan->nr_verify] = plan->indexes[slot];
+		verify_banks[plan->nr_verify] = plan->banks[slot];
+		plan->nr_verify++;
+	}
+	plan->nr_verify_runs = asus_primeb550plus_hwmon_plan_runs(verify_banks, plan->nr_verify, plan->verify_runs);
+}
+
+/*
+ * Reads the registers of a run needed by due fields. Must be called with
+ * update_lock held.
+ */
+static int asus_primeb550plus_hwmon_plan_read_run(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_plan_run const *run, unsigned char const *run_indexes, unsigned long const *needed, unsigned char *dest)
+{
+	unsigned char indexes[ASUS_B550PLUS_HWMON_PLAN_SLOTS], values[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	size_t i, count = 0;
+	int err;
+
+	for (i=0 ; i<run->count ; i++)
+		if (test_bit(run->first + i, needed))
+			indexes[count++] = run_indexes[i];
+	if (!count)
+		return 0;
+
+	if ((err = asus_primeb550plus_hwmon_read_block(devdri_data, run->bank, indexes, count, values)))
+		return err;
+
+	count = 0;
+	for (i=0 ; i<run->count ; i++)
+		if (test_bit(run->first + i, needed))
+			dest[i] = values[count++];
+
+	return 0;
+}
+
+/*
+ * Reads and decodes the fields set in due following the plan, others are
+ * left untouched. A two-byte field whose high byte moved during the sweep
+ * is read again on its own, with the usual retries. Must be called with
+ * update_lock held.
+ */
+static void asus_primeb550plus_hwmon_plan_read(struct asus_primeb550plus_hwmon_data *devdri_data, u64 due, long *values, int *errors)
+{
+	struct asus_primeb550plus_hwmon_read_plan const * const plan = &devdri_data->plan;
+	unsigned char raw[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	int raw_errors[ASUS_B550PLUS_HWMON_PLAN_SLOTS];
+	unsigned char verify[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int verify_errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	DECLARE_BITMAP(needed, ASUS_B550PLUS_HWMON_PLAN_SLOTS);
+	DECLARE_BITMAP(verify_needed, ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+	size_t i, j;
+
+	bitmap_zero(needed, ASUS_B550PLUS_HWMON_PLAN_SLOTS);
+	bitmap_zero(verify_needed, ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		if (!(due & BIT_ULL(i)))
+			continue;
+		for (j=0 ; j<plan->fields[i].nr_regs ; j++)
+			__set_bit(plan->fields[i].slots[j], needed);
+		if (plan->fields[i].nr_regs == 2)
+			__set_bit(plan->fields[i].verify, verify_needed);
+	}
+
+	for (i=0 ; i<plan->nr_runs ; i++) {
+		struct asus_primeb550plus_hwmon_plan_run const * const run = &plan->runs[i];
+		int err = asus_primeb550plus_hwmon_plan_read_run(devdri_data, run, &plan->indexes[run->first], needed, &raw[run->first]);
+
+		for (j=0 ; j<run->count ; j++)
+			raw_errors[run->first + j] = err;
+	}
+
+	for (i=0 ; i<plan->nr_verify_runs ; i++) {
+		struct asus_primeb550plus_hwmon_plan_run const * const run = &plan->verify_runs[i];
+		int err = asus_primeb550plus_hwmon_plan_read_run(devdri_data, run, &plan->verify_indexes[run->first], verify_needed, &verify[run->first]);
+
+		for (j=0 ; j<run->count ; j++)
+			verify_errors[run->first + j] = err;
+	}
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		struct asus_primeb550plus_hwmon_chip_field const * const chip_field = asus_primeb550plus_hwmon_chip_fields[i];
+		unsigned char bytes[2];
+
+		if (!(due & BIT_ULL(i)))
+			continue;
+
+		errors[i] = 0;
+		for (j=0 ; j<plan->fields[i].nr_regs ; j++) {
+			bytes[j] = raw[plan->fields[i].slots[j]];
+			if (raw_errors[plan->fields[i].slots[j]])
+				errors[i] = raw_errors[plan->fields[i].slots[j]];
+		}
+
+		if (!errors[i] && plan->fields[i].nr_regs == 2) {
+			unsigned short const v = plan->fields[i].verify;
+
+			if (verify_errors[v] || verify[v] != bytes[0]) {
+				devdri_data->plan_verify_mismatches++;
+				errors[i] = asus_primeb550plus_hwmon_read_field(devdri_data, chip_field, &values[i]);
+				continue;
+			}
+		}
+
+		if (!errors[i])
+			values[i] = asus_primeb550plus_hwmon_decode_field(chip_field, bytes);
+	}
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_check_limits(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index)
+{
+	struct asus_primeb550plus_hwmon_limits const * const limits = &devdri_data->limits[field_index];
+	long val = devdri_data->values[field_index];
+	unsigned int alarms = 0;
+
+	if (devdri_data->errors[field_index])
+		return;
+
+	if (val < limits->min)
+		alarms |= BIT(ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM);
+	if (val > limits->max)
+		alarms |= BIT(ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM);
+	if (val > limits->crit)
+		alarms |= BIT(ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM);
+	if (alarms)
+		alarms |= BIT(ASUS_B550PLUS_HWMON_ATTR_ALARM);
+
+	devdri_data->alarms_changed[field_index] |= alarms ^ devdri_data->alarms[field_index];
+	devdri_data->alarms[field_index] = alarms;
+	devdri_data->dirty = true;
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_history_add(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index)
+{
+	struct asus_primeb550plus_hwmon_history * const history = &devdri_data->history[field_index];
+	long val = devdri_data->values[field_index];
+
+	if (devdri_data->errors[field_index])
+		return;
+
+	if (!history->valid) {
+		history->valid = true;
+		history->lowest = val;
+		history->highest = val;
+		history->sum = 0;
+		history->samples = 0;
+		history->window_start = jiffies;
+	}
+
+	history->lowest = min(history->lowest, val);
+	history->highest = max(history->highest, val);
+
+	if (time_after(jiffies, history->window_start + msecs_to_jiffies(history->average_interval)) && history->samples) {
+		history->average = div_s64(history->sum, history->samples);
+		history->average_valid = true;
+		history->sum = 0;
+		history->samples = 0;
+		history->window_start = jiffies;
+	}
+
+	history->sum += val;
+	history->samples++;
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_history_reset(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index)
+{
+	struct asus_primeb550plus_hwmon_history * const history = &devdri_data->history[field_index];
+
+	history->valid = false;
+	history->average_valid = false;
+	devdri_data->dirty = true;
+}
+
+/*
+ * Moves a field that was just read to a faster rate class when it changes
+ * by more than its step (at once on a big jump), to a slower one when it
+ * is steady. Intervals range from update_interval to adaptive_max_interval.
+ * Must be called with update_lock held.
+ */
+static void asus_primeb550plus_hwmon_schedule_update(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index)
+{
+	struct asus_primeb550plus_hwmon_schedule * const schedule = &devdri_data->schedule[field_index];
+	long const step = asus_primeb550plus_hwmon_field_step(asus_primeb550plus_hwmon_chip_fields[field_index]);
+	unsigned int const max_interval = READ_ONCE(adaptive_max_interval);
+	unsigned int const update_interval = devdri_data->update_interval;
+	long delta;
+
+	if (devdri_data->errors[field_index] || !max_interval) {
+		schedule->rate_class = 0;
+	} else {
+		delta = schedule->seen ? abs(devdri_data->values[field_index] - schedule->previous) : 0;
+		schedule->change += delta * 4 - schedule->change / 4;
+		schedule->previous = devdri_data->values[field_index];
+		schedule->seen = true;
+
+		if (delta >= 2 * step)
+			schedule->rate_class = 0;
+		else if (schedule->change >= 16 * step && schedule->rate_class)
+			schedule->rate_class--;
+		else if (schedule->change < 4 * step && schedule->rate_class < ASUS_B550PLUS_HWMON_RATE_CLASSES - 1)
+			schedule->rate_class++;
+	}
+
+	schedule->interval = max(min(update_interval << schedule->rate_class, max_interval), update_interval);
+	/* The sampler ticks every update_interval, don't miss the tick by a jiffy */
+	schedule->next_due = jiffies + msecs_to_jiffies(schedule->interval - update_interval / 2);
+}
+
+/*
+ * PWM outputs, in fan channel order. Layout of the related model: each
+ * output has its own bank, the upper nibble of the mode register selects
+ * the chip's own fan control mode (0 is manual, duty taken from the duty
+ * register).
+ */
+static const unsigned char asus_primeb550plus_hwmon_pwm_banks[ASUS_B550PLUS_HWMON_PWM_OUTPUTS] = { 0x01, 0x02, 0x03, 0x08, 0x09, 0x0a, 0x0b };
+#define ASUS_B550PLUS_HWMON_PWM_REG_MODE	0x02
+#define ASUS_B550PLUS_HWMON_PWM_REG_DUTY	0x09
+
+/* pwmN_enable values, as other hwmon drivers */
+enum asus_primeb550plus_hwmon_pwm_enable {
+	ASUS_B550PLUS_HWMON_PWM_MANUAL = 1,
+	ASUS_B550PLUS_HWMON_PWM_CURVE = 2,	/* in-kernel fan curve */
+	ASUS_B550PLUS_HWMON_PWM_CHIP = 5,	/* the chip's own control, as left by the BIOS */
+};
+
+static const long asus_primeb550plus_hwmon_curve_default_temps[ASUS_B550PLUS_HWMON_CURVE_POINTS] = { 40000, 55000, 70000, 85000 };
+static const unsigned char asus_primeb550plus_hwmon_curve_default_pwms[ASUS_B550PLUS_HWMON_CURVE_POINTS] = { 77, 128, 192, 255 };
+#define ASUS_B550PLUS_HWMON_CURVE_HYST_DEFAULT	3000	/* m°C */
+
+/* Takes an output away from the chip's own control. Must be called with update_lock held */
+static int asus_primeb550plus_hwmon_pwm_take(struct asus_primeb550plus_hwmon_data *devdri_data, size_t output)
+{
+	struct asus_primeb550plus_hwmon_fan_curve * const curve = &devdri_data->fan_curves[output];
+	unsigned char const bank = asus_primeb550plus_hwmon_pwm_banks[output];
+	int err;
+
+	if (curve->enable != ASUS_B550PLUS_HWMON_PWM_CHIP)
+		return 0;
+
+	if ((err = asus_primeb550plus_hwmon_read_u8(devdri_data, bank, ASUS_B550PLUS_HWMON_PWM_REG_MODE, &curve->saved_mode)))
+		return err;
+	curve->pwm_valid = false;
+
+	return asus_primeb550plus_hwmon_write_u8(devdri_data, bank, ASUS_B550PLUS_HWMON_PWM_REG_MODE, curve->saved_mode & 0x0f);
+}
+
+/* Hands an output back to the chip. Must be called with update_lock held */
+static int asus_primeb550plus_hwmon_pwm_release(struct asus_primeb550plus_hwmon_data *devdri_data, size_t output)
+{
+	struct asus_primeb550plus_hwmon_fan_curve const * const curve = &devdri_data->fan_curves[output];
+
+	if (curve->enable == ASUS_B550PLUS_HWMON_PWM_CHIP)
+		return 0;
+
+	return asus_primeb550plus_hwmon_write_u8(devdri_data, asus_primeb550plus_hwmon_pwm_banks[output], ASUS_B550PLUS_HWMON_PWM_REG_MODE, curve->saved_mode);
+}
+
+/* Writes the duty of an output, unless the chip already has it. Must be called with update_lock held */
+static int asus_primeb550plus_hwmon_pwm_set(struct asus_primeb550plus_hwmon_data *devdri_data, size_t output, unsigned char pwm)
+{
+	struct asus_primeb550plus_hwmon_fan_curve * const curve = &devdri_data->fan_curves[output];
+	int err;
+
+	if (curve->pwm_valid && curve->pwm == pwm)
+		return 0;
+
+	curve->pwm_valid = false;
+	if ((err = asus_primeb550plus_hwmon_write_u8(devdri_data, asus_primeb550plus_hwmon_pwm_banks[output], ASUS_B550PLUS_HWMON_PWM_REG_DUTY, pwm)))
+		return err;
+	curve->pwm = pwm;
+	curve->pwm_valid = true;
+
+	return 0;
+}
+
+/* Fields read by running curves, they are due on every sweep */
+static u64 asus_primeb550plus_hwmon_fan_curve_fields(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	const struct asus_primeb550plus_hwmon_type_desc * const desc = asus_primeb550plus_hwmon_type_desc_get(hwmon_temp);
+	unsigned long temp_channels = 0;
+	unsigned int channel;
+	u64 fields = 0;
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_PWM_OUTPUTS ; i++)
+		if (devdri_data->fan_curves[i].enable == ASUS_B550PLUS_HWMON_PWM_CURVE)
+			temp_channels |= devdri_data->fan_curves[i].temp_channels;
+
+	for_each_set_bit(channel, &temp_channels, desc->nr_fields)
+		fields |= BIT_ULL(desc->fields[channel]);
+
+	return fields;
+}
+
+/* Hottest valid temperature feeding a curve, or -ENODATA */
+static int asus_primeb550plus_hwmon_fan_curve_temp(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_fan_curve const *curve, long *temp)
+{
+	const struct asus_primeb550plus_hwmon_type_desc * const desc = asus_primeb550plus_hwmon_type_desc_get(hwmon_temp);
+	unsigned int channel;
+	int err = -ENODATA;
+
+	for_each_set_bit(channel, &curve->temp_channels, desc->nr_fields) {
+		size_t const field_index = desc->fields[channel];
+
+		if (devdri_data->errors[field_index])
+			continue;
+		if (err || devdri_data->values[field_index] > *temp)
+			*temp = devdri_data->values[field_index];
+		err = 0;
+	}
+
+	return err;
+}
+
+/* Linear between points, flat outside. Point temperatures are increasing */
+static unsigned char asus_primeb550plus_hwmon_fan_curve_eval(struct asus_primeb550plus_hwmon_fan_curve const *curve, long temp)
+{
+	long const *temps = curve->point_temps;
+	unsigned char const *pwms = curve->point_pwms;
+	size_t i;
+
+	if (temp <= temps[0])
+		return pwms[0];
+
+	for (i=1 ; i<ASUS_B550PLUS_HWMON_CURVE_POINTS ; i++)
+		if (temp < temps[i])
+			return pwms[i - 1] + (pwms[i] - pwms[i - 1]) * (temp - temps[i - 1]) / (temps[i] - temps[i - 1]);
+
+	return pwms[ASUS_B550PLUS_HWMON_CURVE_POINTS - 1];
+}
+
+/*
+ * Applies the curves to the last values read. A rising temperature is
+ * followed at once, a falling one only when it dropped by more than hyst.
+ * Failed writes are retried on the next sweep. Must be called with
+ * update_lock held.
+ */
+static void asus_primeb550plus_hwmon_fan_curves_run(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_PWM_OUTPUTS ; i++) {
+		struct asus_primeb550plus_hwmon_fan_curve * const curve = &devdri_data->fan_curves[i];
+		unsigned char pwm;
+		long temp;
+
+		if (curve->enable != ASUS_B550PLUS_HWMON_PWM_CURVE)
+			continue;
+
+		if (asus_primeb550plus_hwmon_fan_curve_temp(devdri_data, curve, &temp)) {
+			/* Blind, cool as much as possible */
+			curve->temp_valid = false;
+			pwm = U8_MAX;
+		} else {
+			if (!curve->temp_valid || temp > curve->temp || temp < curve->temp - curve->hyst) {
+				curve->temp = temp;
+				curve->temp_valid = true;
+			}
+			pwm = asus_primeb550plus_hwmon_fan_curve_eval(curve, curve->temp);
+		}
+
+		asus_primeb550plus_hwmon_pwm_set(devdri_data, i, pwm);
+	}
+}
+
+/* LEB128, returns the number of bytes written */
+static unsigned int asus_primeb550plus_hwmon_varint(unsigned char *dest, u64 value)
+{
+	unsigned int n = 0;
+
+	while (value >= 0x80) {
+		dest[n++] = value | 0x80;
+		value >>= 7;
+	}
+	dest[n++] = value;
+
+	return n;
+}
+
+static u64 asus_primeb550plus_hwmon_zigzag(s64 value)
+{
+	return ((u64)value << 1) ^ (u64)(value >> 63);
+}
+
+/* Encodes the last sweep against the archive state, which is left untouched */
+static unsigned int asus_primeb550plus_hwmon_archive_encode(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_archive_block const *block, u64 valid, u64 *ms, unsigned char *dest)
+{
+	unsigned int n;
+	size_t i;
+
+	*ms = div_u64(devdri_data->last_updated_ns - block->start_ns, NSEC_PER_MSEC);
+	n = asus_primeb550plus_hwmon_varint(dest, *ms - devdri_data->archive.last_ms);
+	n += asus_primeb550plus_hwmon_varint(dest + n, valid ^ devdri_data->archive.valid);
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if (valid & BIT_ULL(i))
+			n += asus_primeb550plus_hwmon_varint(dest + n, asus_primeb550plus_hwmon_zigzag(devdri_data->values[i] - devdri_data->archive.values[i]));
+
+	return n;
+}
+
+/* Appends the last sweep, starting a new block (over the oldest) when full. Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_archive_add(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	unsigned char sample[ASUS_B550PLUS_HWMON_ARCHIVE_SAMPLE_MAX];
+	struct asus_primeb550plus_hwmon_archive_block *block = NULL;
+	unsigned int len = 0;
+	u64 valid = 0, ms;
+	size_t i;
+
+	if (!devdri_data->archive.nr_blocks)
+		return;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if ((devdri_data->present & BIT_ULL(i)) && !devdri_data->errors[i])
+			valid |= BIT_ULL(i);
+
+	if (devdri_data->archive.head) {
+		block = &devdri_data->archive.blocks[(devdri_data->archive.head - 1) % devdri_data->archive.nr_blocks];
+		len = asus_primeb550plus_hwmon_archive_encode(devdri_data, block, valid, &ms, sample);
+	}
+
+	if (!block || len > sizeof(block->payload) - block->used) {
+		block = &devdri_data->archive.blocks[devdri_data->archive.head % devdri_data->archive.nr_blocks];
+		block->magic = ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_MAGIC;
+		block->version = ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_VERSION;
+		block->used = 0;
+		block->sequence = devdri_data->archive.head++;
+		block->start_ns = devdri_data->last_updated_ns;
+		block->channels = devdri_data->present;
+		block->nr_samples = 0;
+		block->reserved = 0;
+
+		devdri_data->archive.last_ms = 0;
+		devdri_data->archive.valid = devdri_data->present;
+		memset(devdri_data->archive.values, 0, sizeof(devdri_data->archive.values));
+		len = asus_primeb550plus_hwmon_archive_encode(devdri_data, block, valid, &ms, sample);
+	}
+
+	memcpy(block->payload + block->used, sample, len);
+	block->used += len;
+	block->nr_samples++;
+
+	devdri_data->archive.last_ms = ms;
+	devdri_data->archive.valid = valid;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if (valid & BIT_ULL(i))
+			devdri_data->archive.values[i] = devdri_data->values[i];
+}
+
+/* Fields of the given channels (bit n for channel n) of a sensor type */
+static u64 asus_primeb550plus_hwmon_channel_fields(enum hwmon_sensor_types type, unsigned long channels)
+{
+	const struct asus_primeb550plus_hwmon_type_desc * const desc = asus_primeb550plus_hwmon_type_desc_get(type);
+	unsigned int channel;
+	u64 fields = 0;
+
+	for_each_set_bit(channel, &channels, desc->nr_fields)
+		fields |= BIT_ULL(desc->fields[channel]);
+
+	return fields;
+}
+
+/* Fields watched for stalls */
+static u64 asus_primeb550plus_hwmon_watchdog_stall_fields(void)
+{
+	return READ_ONCE(watchdog_fan_min) ? asus_primeb550plus_hwmon_channel_fields(hwmon_fan, READ_ONCE(watchdog_fans)) : 0;
+}
+
+/* Fields watched for overtemperature */
+static u64 asus_primeb550plus_hwmon_watchdog_hot_fields(void)
+{
+	return READ_ONCE(watchdog_temp_max) ? asus_primeb550plus_hwmon_channel_fields(hwmon_temp, READ_ONCE(watchdog_temps)) : 0;
+}
+
+/* Fields watched by the watchdog, they are due on every sweep */
+static u64 asus_primeb550plus_hwmon_watchdog_fields(void)
+{
+	return asus_primeb550plus_hwmon_watchdog_stall_fields() | asus_primeb550plus_hwmon_watchdog_hot_fields();
+}
+
+/*
+ * Raises a change uevent on the hwmon device (EVENT, CHANNEL, LABEL and
+ * VALUE), then powers off if asked to. Must be called with update_lock
+ * held, detected_ns is the time of the sweep that tripped.
+ */
+static void asus_primeb550plus_hwmon_watchdog_trip(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index, bool stall, u64 detected_ns)
+{
+	const char * const event = stall ? "fan_stall" : "overtemperature";
+	const struct asus_primeb550plus_hwmon_type_desc *desc;
+	char env[4][48];
+	char *envp[] = { env[0], env[1], env[2], env[3], NULL };
+	u64 latency;
+	int channel;
+
+	desc = asus_primeb550plus_hwmon_field_channel(field_index, &channel);
+	snprintf(env[0], sizeof(env[0]), "EVENT=%s", event);
+	snprintf(env[1], sizeof(env[1]), "CHANNEL=%s%d", desc->name, desc->index_base + channel);
+	snprintf(env[2], sizeof(env[2]), "LABEL=%s", asus_primeb550plus_hwmon_chip_fields[field_index]->label);
+	snprintf(env[3], sizeof(env[3]), "VALUE=%ld", devdri_data->values[field_index]);
+
+	if (devdri_data->device) {
+		dev_crit(devdri_data->device, "%s on %s%d (%s): %ld\n", event, desc->name, desc->index_base + channel, asus_primeb550plus_hwmon_chip_fields[field_index]->label, devdri_data->values[field_index]);
+		kobject_uevent_env(&devdri_data->device->kobj, KOBJ_CHANGE, envp);
+	}
+
+	if (READ_ONCE(watchdog_shutdown))
+		hw_protection_shutdown(stall ? "asus_primeb550plus_hwmon: fan stall" : "asus_primeb550plus_hwmon: overtemperature", ASUS_B550PLUS_HWMON_WATCHDOG_FORCE_MS);
+
+	latency = ktime_get_ns() - detected_ns;
+	devdri_data->watchdog_trips++;
+	devdri_data->watchdog_latency_ns = latency;
+	devdri_data->watchdog_latency_max_ns = max(devdri_data->watchdog_latency_max_ns, latency);
+	devdri_data->watchdog_debounce_ns = detected_ns - devdri_data->watchdog[field_index].first_ns;
+}
+
+/*
+ * Runs right after the fields were read, with update_lock held. A
+ * watched field trips once past its threshold for watchdog_debounce
+ * sweeps in a row, and can only trip again after it got back. Failed
+ * reads leave the count as it is.
+ */
+static void asus_primeb550plus_hwmon_watchdog_check(struct asus_primeb550plus_hwmon_data *devdri_data, u64 now)
+{
+	u64 const stall = asus_primeb550plus_hwmon_watchdog_stall_fields() & devdri_data->present;
+	u64 const hot = asus_primeb550plus_hwmon_watchdog_hot_fields() & devdri_data->present;
+	unsigned int const debounce = max(READ_ONCE(watchdog_debounce), 1U);
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		struct asus_primeb550plus_hwmon_watchdog * const watchdog = &devdri_data->watchdog[i];
+		long const value = devdri_data->values[i];
+		bool past;
+
+		if (!((stall | hot) & BIT_ULL(i))) {
+			watchdog->count = 0;
+			watchdog->tripped = false;
+			continue;
+		}
+		if (devdri_data->errors[i])
+			continue;
+
+		if (stall & BIT_ULL(i))
+			past = value < READ_ONCE(watchdog_fan_min);
+		else
+			past = value > READ_ONCE(watchdog_temp_max);
+		if (!past) {
+			watchdog->count = 0;
+			watchdog->tripped = false;
+			continue;
+		}
+
+		if (!watchdog->count++)
+			watchdog->first_ns = now;
+		if (watchdog->tripped || watchdog->count < debounce)
+			continue;
+
+		watchdog->tripped = true;
+		asus_primeb550plus_hwmon_watchdog_trip(devdri_data, i, stall & BIT_ULL(i), now);
+	}
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_sweep(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	u64 due = 0, now;
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if (!devdri_data->valid || !time_before(jiffies, devdri_data->schedule[i].next_due))
+			due |= BIT_ULL(i);
+	due |= asus_primeb550plus_hwmon_fan_curve_fields(devdri_data);
+	due |= asus_primeb550plus_hwmon_watchdog_fields();
+	due &= devdri_data->present;
+
+	asus_primeb550plus_hwmon_plan_read(devdri_data, due, devdri_data->values, devdri_data->errors);
+	now = ktime_get_ns();
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		if (!(due & BIT_ULL(i)))
+			continue;
+		/* *_age is the age of the last good value */
+		if (!devdri_data->errors[i])
+			devdri_data->read_ns[i] = now;
+		asus_primeb550plus_hwmon_schedule_update(devdri_data, i);
+		asus_primeb550plus_hwmon_check_limits(devdri_data, i);
+		asus_primeb550plus_hwmon_history_add(devdri_data, i);
+	}
+
+	asus_primeb550plus_hwmon_watchdog_check(devdri_data, now);
+	asus_primeb550plus_hwmon_fan_curves_run(devdri_data);
+
+	devdri_data->last_updated = jiffies;
+	devdri_data->last_updated_ns = now;
+	devdri_data->valid = true;
+	devdri_data->dirty = true;
+	devdri_data->cache_misses++;
+
+	asus_primeb550plus_hwmon_archive_add(devdri_data);
+}
+
+/* Sweeps unless the last one is younger than max_age ms. Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_update(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned long max_age)
+{
+	if (!devdri_data->valid || time_after(jiffies, devdri_data->last_updated + msecs_to_jiffies(max_age)))
+		asus_primeb550plus_hwmon_sweep(devdri_data);
+}
+
+/* Must be called with update_lock held */
+static void asus_primeb550plus_hwmon_publish(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct asus_primeb550plus_hwmon_snapshot *snapshot, *old;
+	size_t i;
+
+	/* Readers keep the previous snapshot, try again next time */
+	if (!(snapshot = kmalloc(sizeof(*snapshot), GFP_KERNEL)))
+		return;
+
+	snapshot->timestamp = devdri_data->last_updated;
+	snapshot->timestamp_ns = devdri_data->last_updated_ns;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		struct asus_primeb550plus_hwmon_snapshot_field * const field = &snapshot->fields[i];
+		struct asus_primeb550plus_hwmon_history const * const history = &devdri_data->history[i];
+
+		field->value = devdri_data->values[i];
+		field->error = devdri_data->errors[i];
+		field->read_ns = devdri_data->read_ns[i];
+		field->alarms = devdri_data->alarms[i];
+		field->history_valid = history->valid;
+		field->lowest = history->lowest;
+		field->highest = history->highest;
+		/* The first window is not complete yet, give what we have */
+		field->average_valid = history->average_valid || history->samples;
+		if (history->average_valid)
+			field->average = history->average;
+		else if (history->samples)
+			field->average = div_s64(history->sum, history->samples);
+	}
+
+	old = rcu_replace_pointer(devdri_data->snapshot, snapshot, lockdep_is_held(&devdri_data->update_lock));
+	if (old)
+		kfree_rcu(old, rcu);
+
+	devdri_data->dirty = false;
+}
+
+/*
+ * Publishes changes made while update_lock was held, releases it, then
+ * notifies alarm changes (notifying may end up reading attributes back).
+ */
+static void asus_primeb550plus_hwmon_unlock(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	unsigned int changed[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	struct device *hwmon_dev;
+	bool any = false;
+	size_t i;
+
+	if (devdri_data->dirty)
+		asus_primeb550plus_hwmon_publish(devdri_data);
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		changed[i] = devdri_data->alarms_changed[i];
+		devdri_data->alarms_changed[i] = 0;
+		any |= !!changed[i];
+	}
+	hwmon_dev = devdri_data->device;
+
+	mutex_unlock(&devdri_data->update_lock);
+
+	if (!any || !hwmon_dev)
+		return;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc;
+		unsigned long kinds = changed[i];
+		unsigned int kind;
+		int channel;
+
+		if (!kinds)
+			continue;
+		if (!(desc = asus_primeb550plus_hwmon_field_channel(i, &channel)))
+			continue;
+
+		kinds &= desc->kinds;
+		for_each_set_bit(kind, &kinds, ASUS_B550PLUS_HWMON_ATTR_KIND_MAX)
+			hwmon_notify_event(hwmon_dev, desc->type, desc->attrs[kind], channel);
+	}
+}
+
+/* Sweeps unless the last one is younger than max_age ms, and publishes the result */
+static void asus_primeb550plus_hwmon_refresh(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned long max_age)
+{
+	mutex_lock(&devdri_data->update_lock);
+	asus_primeb550plus_hwmon_update(devdri_data, max_age);
+	asus_primeb550plus_hwmon_unlock(devdri_data);
+}
+
+/* Lock-free, never touches the chip */
+static struct workqueue_struct *asus_primeb550plus_hwmon_sampler_wq(void)
+{
+	return low_wakeup ? system_power_efficient_wq : system_wq;
+}
+
+/* A deferrable timer may wait for an idle CPU forever, curves and the watchdog can't */
+static struct delayed_work *asus_primeb550plus_hwmon_sampler_dwork(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	return READ_ONCE(devdri_data->sampler_timely) ? &devdri_data->sampler_timely_work : &devdri_data->sampler_work;
+}
+
+/*
+ * Called by readers, may sleep. Values older than update_interval +
+ * sampler_slack are still served, but the sampler is asked to sweep at
+ * once (stale while revalidate). Beyond update_interval + max_staleness,
+ * the reader sweeps itself. With low_wakeup, also notes that values are
+ * being read and brings a backed off sampler back to its pace.
+ */
+static void asus_primeb550plus_hwmon_consume(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	unsigned long const interval = READ_ONCE(devdri_data->update_interval);
+	unsigned long const last_updated = READ_ONCE(devdri_data->last_updated);
+	unsigned int const staleness = READ_ONCE(max_staleness);
+	u64 sweeps;
+
+	if (low_wakeup && READ_ONCE(devdri_data->last_consumed) != jiffies)
+		WRITE_ONCE(devdri_data->last_consumed, jiffies);
+
+	if ((low_wakeup && READ_ONCE(devdri_data->sampler_period) > interval) || time_after(jiffies, last_updated + msecs_to_jiffies(interval + READ_ONCE(sampler_slack))))
+		mod_delayed_work(asus_primeb550plus_hwmon_sampler_wq(), asus_primeb550plus_hwmon_sampler_dwork(devdri_data), 0);
+
+	if (!staleness || !time_after(jiffies, last_updated + msecs_to_jiffies(interval + staleness)))
+		return;
+
+	mutex_lock(&devdri_data->update_lock);
+	sweeps = devdri_data->cache_misses;
+	asus_primeb550plus_hwmon_update(devdri_data, interval + staleness);
+	devdri_data->catch_ups += devdri_data->cache_misses - sweeps;
+	asus_primeb550plus_hwmon_unlock(devdri_data);
+}
+
+static int asus_primeb550plus_hwmon_get_value(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index, long *val)
+{
+	struct asus_primeb550plus_hwmon_snapshot const *snapshot;
+	int err;
+
+	asus_primeb550plus_hwmon_consume(devdri_data);
+
+	rcu_read_lock();
+	snapshot = rcu_dereference(devdri_data->snapshot);
+	err = snapshot->fields[field_index].error;
+	*val = snapshot->fields[field_index].value;
+	rcu_read_unlock();
+
+	this_cpu_inc(*devdri_data->cache_hits);
+
+	return err;
+}
+
+/*
+ * low_wakeup: the period doubles (up to the longest update_interval) while
+ * nobody read values for a few periods, and is back to update_interval
+ * once someone does. Running fan curves and the watchdog need every
+ * sweep, on time.
+ */
+static unsigned long asus_primeb550plus_hwmon_sampler_period(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned long interval)
+{
+	unsigned long period = devdri_data->sampler_period;
+	bool every_sweep;
+
+	mutex_lock(&devdri_data->update_lock);
+	every_sweep = asus_primeb550plus_hwmon_fan_curve_fields(devdri_data) || asus_primeb550plus_hwmon_watchdog_fields();
+	mutex_unlock(&devdri_data->update_lock);
+	WRITE_ONCE(devdri_data->sampler_timely, every_sweep);
+
+	if (every_sweep || !time_after(jiffies, READ_ONCE(devdri_data->last_consumed) + msecs_to_jiffies(ASUS_B550PLUS_HWMON_SAMPLER_IDLE_PERIODS * period)))
+		period = interval;
+	else
+		period = min_t(unsigned long, period * 2, ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_MAX);
+
+	return max(period, interval);
+}
+
+/* Background sampler, keeps alarms and history up to date while no one reads */
+static void asus_primeb550plus_hwmon_sampler_run(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct delayed_work *dwork;
+	unsigned long interval, period;
+	u64 now;
+
+	interval = READ_ONCE(devdri_data->update_interval);
+	asus_primeb550plus_hwmon_refresh(devdri_data, interval);
+
+	now = ktime_get_ns();
+	if (devdri_data->sampler_wakeups++) {
+		u64 const elapsed = div_u64(now - devdri_data->sampler_last_ns, NSEC_PER_USEC);
+		u64 const achieved = devdri_data->sampler_achieved_us;
+
+		devdri_data->sampler_achieved_us = achieved ? achieved - achieved / 8 + elapsed / 8 : elapsed;
+	}
+	devdri_data->sampler_last_ns = now;
+
+	period = low_wakeup ? asus_primeb550plus_hwmon_sampler_period(devdri_data, interval) : interval;
+	WRITE_ONCE(devdri_data->sampler_period, period);
+
+	/* Only one of the two stays queued */
+	dwork = asus_primeb550plus_hwmon_sampler_dwork(devdri_data);
+	cancel_delayed_work(dwork == &devdri_data->sampler_work ? &devdri_data->sampler_timely_work : &devdri_data->sampler_work);
+	queue_delayed_work(asus_primeb550plus_hwmon_sampler_wq(), dwork, msecs_to_jiffies(period));
+}
+
+static void asus_primeb550plus_hwmon_sampler_work(struct work_struct *work)
+{
+	asus_primeb550plus_hwmon_sampler_run(container_of(to_delayed_work(work), struct asus_primeb550plus_hwmon_data, sampler_work));
+}
+
+static void asus_primeb550plus_hwmon_sampler_timely_work(struct work_struct *work)
+{
+	asus_primeb550plus_hwmon_sampler_run(container_of(to_delayed_work(work), struct asus_primeb550plus_hwmon_data, sampler_timely_work));
+}
+
+static void asus_primeb550plus_hwmon_sampler_stop(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	/* Readers may kick it (low_wakeup) until the hwmon device is gone */
+	disable_delayed_work_sync(&devdri_data->sampler_work);
+	disable_delayed_work_sync(&devdri_data->sampler_timely_work);
+}
+
+/*
+ * Channels start absent (but force_present ones) and read as no data
+ * everywhere (snapshot, streams, all_sensors) until a detection pass
+ * finds them connected.
+ */
+static void asus_primeb550plus_hwmon_presence_init(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	size_t i;
+
+	devdri_data->present = force_present & ASUS_B550PLUS_HWMON_ALL_FIELDS;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if (!(devdri_data->present & BIT_ULL(i)))
+			devdri_data->errors[i] = -ENODATA;
+}
+
+/* Registers or replay trace changed under the emulated instance, detect again now */
+static void asus_primeb550plus_hwmon_presence_recheck(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	mod_delayed_work(system_power_efficient_wq, &devdri_data->presence_work, 0);
+}
+
+static umode_t asus_primeb550plus_hwmon_kind_mode(unsigned int kind)
+{
+	if (BIT(kind) & (ASUS_B550PLUS_HWMON_LIMIT_KINDS | BIT(ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL)))
+		return 0644;
+	if (kind == ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY)
+		return 0200;
+	return 0444;
+}
+
+static umode_t asus_primeb550plus_hwmon_is_visible(const void *drvdata, enum hwmon_sensor_types type, u32 attr, int channel)
+{
+	struct asus_primeb550plus_hwmon_data const * const devdri_data = drvdata;
+	const struct asus_primeb550plus_hwmon_type_desc *desc;
+	int kind;
+
+	if (type == hwmon_chip) {
+		switch(attr) {
+			case hwmon_chip_update_interval:
+				return 0644;
+			case hwmon_chip_in_reset_history:
+			case hwmon_chip_temp_reset_history:
+				return 0200;
+			default:
+				return 0;
+		}
+	}
+
+	if (type == hwmon_pwm)
+		return devdri_data->writable ? 0644 : 0;
+
+	if (!(desc = asus_primeb550plus_hwmon_type_desc_get(type)))
+		return 0;
+	if ((kind = asus_primeb550plus_hwmon_attr_kind(desc, attr)) < 0)
+		return 0;
+	if (channel >= desc->nr_fields || !(devdri_data->present & BIT_ULL(desc->fields[channel])))
+		return 0;
+
+	return asus_primeb550plus_hwmon_kind_mode(kind);
+}
+
+static int asus_primeb550plus_hwmon_field_read(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index, unsigned int kind, long *val)
+{
+	struct asus_primeb550plus_hwmon_snapshot_field const *field;
+	int err = 0;
+
+	switch(kind) {
+		case ASUS_B550PLUS_HWMON_ATTR_INPUT:
+			return asus_primeb550plus_hwmon_get_value(devdri_data, field_index, val);
+		case ASUS_B550PLUS_HWMON_ATTR_MIN:
+			*val = READ_ONCE(devdri_data->limits[field_index].min);
+			return 0;
+		case ASUS_B550PLUS_HWMON_ATTR_MAX:
+			*val = READ_ONCE(devdri_data->limits[field_index].max);
+			return 0;
+		case ASUS_B550PLUS_HWMON_ATTR_CRIT:
+			*val = READ_ONCE(devdri_data->limits[field_index].crit);
+			return 0;
+		case ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL:
+			*val = READ_ONCE(devdri_data->history[field_index].average_interval);
+			return 0;
+		case ASUS_B550PLUS_HWMON_ATTR_ALARM:
+		case ASUS_B550PLUS_HWMON_ATTR_MIN_ALARM:
+		case ASUS_B550PLUS_HWMON_ATTR_MAX_ALARM:
+		case ASUS_B550PLUS_HWMON_ATTR_CRIT_ALARM:
+		case ASUS_B550PLUS_HWMON_ATTR_LOWEST:
+		case ASUS_B550PLUS_HWMON_ATTR_HIGHEST:
+		case ASUS_B550PLUS_HWMON_ATTR_AVERAGE:
+		case ASUS_B550PLUS_HWMON_ATTR_AGE:
+			break;
+		default:
+			return -EOPNOTSUPP;
+	}
+
+	asus_primeb550plus_hwmon_consume(devdri_data);
+
+	rcu_read_lock();
+	field = &rcu_dereference(devdri_data->snapshot)->fields[field_index];
+
+	switch(kind) {
+		case ASUS_B550PLUS_HWMON_ATTR_LOWEST:
+			if (field->history_valid)
+				*val = field->lowest;
+			else
+				err = -ENODATA;
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_HIGHEST:
+			if (field->history_valid)
+				*val = field->highest;
+			else
+				err = -ENODATA;
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_AVERAGE:
+			if (field->average_valid)
+				*val = field->average;
+			else
+				err = -ENODATA;
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_AGE:
+			*val = div_u64(ktime_get_ns() - field->read_ns, NSEC_PER_MSEC);
+			break;
+		default:
+			*val = !!(field->alarms & BIT(kind));
+			break;
+	}
+
+	rcu_read_unlock();
+
+	return err;
+}
+
+static int asus_primeb550plus_hwmon_field_write(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index, unsigned int kind, long val)
+{
+	struct asus_primeb550plus_hwmon_limits *limits = &devdri_data->limits[field_index];
+	long lowest, highest;
+
+	switch(kind) {
+		case ASUS_B550PLUS_HWMON_ATTR_MIN:
+		case ASUS_B550PLUS_HWMON_ATTR_MAX:
+		case ASUS_B550PLUS_HWMON_ATTR_CRIT:
+			asus_primeb550plus_hwmon_field_range(asus_primeb550plus_hwmon_chip_fields[field_index], &lowest, &highest);
+			val = clamp_val(val, lowest, highest);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL:
+			val = clamp_val(val, ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_MIN, ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_MAX);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY:
+			break;
+		default:
+			return -EOPNOTSUPP;
+	}
+
+	mutex_lock(&devdri_data->update_lock);
+
+	switch(kind) {
+		case ASUS_B550PLUS_HWMON_ATTR_MIN:
+			WRITE_ONCE(limits->min, val);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_MAX:
+			WRITE_ONCE(limits->max, val);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_CRIT:
+			WRITE_ONCE(limits->crit, val);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_AVERAGE_INTERVAL:
+			WRITE_ONCE(devdri_data->history[field_index].average_interval, val);
+			asus_primeb550plus_hwmon_history_reset(devdri_data, field_index);
+			break;
+		case ASUS_B550PLUS_HWMON_ATTR_RESET_HISTORY:
+			asus_primeb550plus_hwmon_history_reset(devdri_data, field_index);
+			break;
+	}
+
+	if (devdri_data->valid && (BIT(kind) & ASUS_B550PLUS_HWMON_LIMIT_KINDS))
+		asus_primeb550plus_hwmon_check_limits(devdri_data, field_index);
+
+	asus_primeb550plus_hwmon_unlock(devdri_data);
+
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_pwm_read(struct asus_primeb550plus_hwmon_data *devdri_data, u32 attr, int channel, long *val)
+{
+	struct asus_primeb550plus_hwmon_fan_curve const * const curve = &devdri_data->fan_curves[channel];
+	unsigned char duty;
+	int err = 0;
+
+	mutex_lock(&devdri_data->update_lock);
+
+	switch(attr) {
+		case hwmon_pwm_input:
+			if (curve->pwm_valid) {
+				*val = curve->pwm;
+			} else if (!(err = asus_primeb550plus_hwmon_read_u8(devdri_data, asus_primeb550plus_hwmon_pwm_banks[channel], ASUS_B550PLUS_HWMON_PWM_REG_DUTY, &duty))) {
+				*val = duty;
+			}
+			break;
+		case hwmon_pwm_enable:
+			*val = curve->enable;
+			break;
+		case hwmon_pwm_auto_channels_temp:
+			*val = curve->temp_channels;
+			break;
+		default:
+			err = -EOPNOTSUPP;
+	}
+
+	mutex_unlock(&devdri_data->update_lock);
+
+	return err;
+}
+
+static int asus_primeb550plus_hwmon_pwm_write(struct asus_primeb550plus_hwmon_data *devdri_data, u32 attr, int channel, long val)
+{
+	struct asus_primeb550plus_hwmon_fan_curve * const curve = &devdri_data->fan_curves[channel];
+	int err = 0;
+
+	switch(attr) {
+		case hwmon_pwm_input:
+			if (val < 0 || val > U8_MAX)
+				return -EINVAL;
+			break;
+		case hwmon_pwm_enable:
+			if (val != ASUS_B550PLUS_HWMON_PWM_MANUAL && val != ASUS_B550PLUS_HWMON_PWM_CURVE && val != ASUS_B550PLUS_HWMON_PWM_CHIP)
+				return -EINVAL;
+			break;
+		case hwmon_pwm_auto_channels_temp:
+			if (val <= 0 || val >= BIT(asus_primeb550plus_hwmon_type_desc_get(hwmon_temp)->nr_fields))
+				return -EINVAL;
+			break;
+		default:
+			return -EOPNOTSUPP;
+	}
+
+	mutex_lock(&devdri_data->update_lock);
+
+	switch(attr) {
+		case hwmon_pwm_input:
+			if (curve->enable != ASUS_B550PLUS_HWMON_PWM_MANUAL)
+				err = -EBUSY;
+			else
+				err = asus_primeb550plus_hwmon_pwm_set(devdri_data, channel, val);
+			break;
+		case hwmon_pwm_enable:
+			if (val == ASUS_B550PLUS_HWMON_PWM_CHIP)
+				err = asus_primeb550plus_hwmon_pwm_release(devdri_data, channel);
+			else
+				err = asus_primeb550plus_hwmon_pwm_take(devdri_data, channel);
+			if (err)
+				break;
+			curve->enable = val;
+			curve->temp_valid = false;
+			/* Don't wait for the next sweep */
+			asus_primeb550plus_hwmon_fan_curves_run(devdri_data);
+			break;
+		case hwmon_pwm_auto_channels_temp:
+			curve->temp_channels = val;
+			curve->temp_valid = false;
+			break;
+	}
+
+	mutex_unlock(&devdri_data->update_lock);
+
+	/* A low_wakeup sampler may be deferred, have the next sweeps on time */
+	if (low_wakeup && !err && attr == hwmon_pwm_enable && val == ASUS_B550PLUS_HWMON_PWM_CURVE) {
+		WRITE_ONCE(devdri_data->sampler_timely, true);
+		mod_delayed_work(asus_primeb550plus_hwmon_sampler_wq(), &devdri_data->sampler_timely_work, msecs_to_jiffies(READ_ONCE(devdri_data->update_interval)));
+	}
+
+	return err;
+}
+
+static int asus_primeb550plus_hwmon_read(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel, long *val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(dev);
+	int field_index, kind;
+
+	if (type == hwmon_chip) {
+		if (attr != hwmon_chip_update_interval)
+			return -EOPNOTSUPP;
+		*val = devdri_data->update_interval;
+		return 0;
+	}
+
+	if (type == hwmon_pwm)
+		return asus_primeb550plus_hwmon_pwm_read(devdri_data, attr, channel, val);
+
+	if ((field_index = asus_primeb550plus_hwmon_field_index(type, channel)) < 0)
+		return field_index;
+	if ((kind = asus_primeb550plus_hwmon_attr_kind(asus_primeb550plus_hwmon_type_desc_get(type), attr)) < 0)
+		return kind;
+
+	return asus_primeb550plus_hwmon_field_read(devdri_data, field_index, kind, val);
+}
+
+static int asus_primeb550plus_hwmon_read_string(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel, const char **str)
+{
+	int field_index;
+
+	if ((field_index = asus_primeb550plus_hwmon_field_index(type, channel)) < 0)
+		return field_index;
+
+	*str = asus_primeb550plus_hwmon_chip_fields[field_index]->label;
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_chip_write(struct asus_primeb550plus_hwmon_data *devdri_data, u32 attr, long val)
+{
+	const struct asus_primeb550plus_hwmon_type_desc *desc;
+	size_t i;
+
+	switch(attr) {
+		case hwmon_chip_update_interval:
+			mutex_lock(&devdri_data->update_lock);
+			devdri_data->update_interval = clamp_val(val, ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_MIN, ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_MAX);
+			mutex_unlock(&devdri_data->update_lock);
+			return 0;
+		case hwmon_chip_in_reset_history:
+			desc = asus_primeb550plus_hwmon_type_desc_get(hwmon_in);
+			break;
+		case hwmon_chip_temp_reset_history:
+			desc = asus_primeb550plus_hwmon_type_desc_get(hwmon_temp);
+			break;
+		default:
+			return -EOPNOTSUPP;
+	}
+
+	mutex_lock(&devdri_data->update_lock);
+	for (i=0 ; i<desc->nr_fields ; i++)
+		asus_primeb550plus_hwmon_history_reset(devdri_data, desc->fields[i]);
+	asus_primeb550plus_hwmon_unlock(devdri_data);
+
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_write(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel, long val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(dev);
+	int field_index, kind;
+
+	if (type == hwmon_chip)
+		return asus_primeb550plus_hwmon_chip_write(devdri_data, attr, val);
+	if (type == hwmon_pwm)
+		return asus_primeb550plus_hwmon_pwm_write(devdri_data, attr, channel, val);
+
+	if ((field_index = asus_primeb550plus_hwmon_field_index(type, channel)) < 0)
+		return field_index;
+	if ((kind = asus_primeb550plus_hwmon_attr_kind(asus_primeb550plus_hwmon_type_desc_get(type), attr)) < 0)
+		return kind;
+
+	return asus_primeb550plus_hwmon_field_write(devdri_data, field_index, kind, val);
+}
+
+static ssize_t asus_primeb550plus_hwmon_extra_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct sensor_device_attribute_2 const * const sda = to_sensor_dev_attr_2(attr);
+	long val;
+	int err;
+
+	if ((err = asus_primeb550plus_hwmon_field_read(dev_get_drvdata(dev), sda->index, sda->nr, &val)))
+		return err;
+
+	return sysfs_emit(buf, "%ld\n", val);
+}
+
+static ssize_t asus_primeb550plus_hwmon_extra_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct sensor_device_attribute_2 const * const sda = to_sensor_dev_attr_2(attr);
+	long val;
+	int err;
+
+	if ((err = kstrtol(buf, 10, &val)))
+		return err;
+	if ((err = asus_primeb550plus_hwmon_field_write(dev_get_drvdata(dev), sda->index, sda->nr, val)))
+		return err;
+
+	return count;
+}
+
+/* Fan curve attributes, sda.index is output * ASUS_B550PLUS_HWMON_CURVE_POINTS + point */
+enum asus_primeb550plus_hwmon_curve_attr {
+	ASUS_B550PLUS_HWMON_CURVE_POINT_TEMP,
+	ASUS_B550PLUS_HWMON_CURVE_POINT_PWM,
+	ASUS_B550PLUS_HWMON_CURVE_HYST,
+};
+
+static ssize_t asus_primeb550plus_hwmon_curve_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct sensor_device_attribute_2 const * const sda = to_sensor_dev_attr_2(attr);
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(dev);
+	struct asus_primeb550plus_hwmon_fan_curve const * const curve = &devdri_data->fan_curves[sda->index / ASUS_B550PLUS_HWMON_CURVE_POINTS];
+	unsigned int const point = sda->index % ASUS_B550PLUS_HWMON_CURVE_POINTS;
+	long val;
+
+	mutex_lock(&devdri_data->update_lock);
+	switch(sda->nr) {
+		case ASUS_B550PLUS_HWMON_CURVE_POINT_TEMP:
+			val = curve->point_temps[point];
+			break;
+		case ASUS_B550PLUS_HWMON_CURVE_POINT_PWM:
+			val = curve->point_pwms[point];
+			break;
+		default:
+			val = curve->hyst;
+	}
+	mutex_unlock(&devdri_data->update_lock);
+
+	return sysfs_emit(buf, "%ld\n", val);
+}
+
+static ssize_t asus_primeb550plus_hwmon_curve_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct sensor_device_attribute_2 const * const sda = to_sensor_dev_attr_2(attr);
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(dev);
+	struct asus_primeb550plus_hwmon_fan_curve * const curve = &devdri_data->fan_curves[sda->index / ASUS_B550PLUS_HWMON_CURVE_POINTS];
+	unsigned int const point = sda->index % ASUS_B550PLUS_HWMON_CURVE_POINTS;
+	long val;
+	int err;
+
+	if ((err = kstrtol(buf, 10, &val)))
+		return err;
+
+	mutex_lock(&devdri_data->update_lock);
+	switch(sda->nr) {
+		case ASUS_B550PLUS_HWMON_CURVE_POINT_TEMP:
+			val = clamp_val(val, ASUS_B550PLUS_HWMON_CURVE_TEMP_MIN, ASUS_B550PLUS_HWMON_CURVE_TEMP_MAX);
+			/* Points stay in increasing temperature order */
+			if ((point > 0 && val < curve->point_temps[point - 1]) || (point < ASUS_B550PLUS_HWMON_CURVE_POINTS - 1 && val > curve->point_temps[point + 1]))
+				err = -EINVAL;
+			else
+				curve->point_temps[point] = val;
+			break;
+		case ASUS_B550PLUS_HWMON_CURVE_POINT_PWM:
+			if (val < 0 || val > U8_MAX)
+				err = -EINVAL;
+			else
+				curve->point_pwms[point] = val;
+			break;
+		default:
+			curve->hyst = clamp_val(val, 0, ASUS_B550PLUS_HWMON_CURVE_HYST_MAX);
+	}
+	mutex_unlock(&devdri_data->update_lock);
+
+	return err ? err : count;
+}
+
+static ssize_t asus_primeb550plus_hwmon_bulk_read(struct file *file, struct kobject *kobj, const struct bin_attribute *attr, char *buf, loff_t off, size_t count)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(kobj_to_dev(kobj));
+	struct asus_primeb550plus_hwmon_snapshot const *snapshot;
+	struct asus_primeb550plus_hwmon_bulk bulk = {
+		.version = ASUS_PRIMEB550PLUS_HWMON_BULK_VERSION,
+		.nr_channels = ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS,
+	};
+	size_t i;
+
+	if (off >= sizeof(bulk))
+		return 0;
+	count = min_t(size_t, count, sizeof(bulk) - off);
+
+	asus_primeb550plus_hwmon_consume(devdri_data);
+
+	rcu_read_lock();
+	snapshot = rcu_dereference(devdri_data->snapshot);
+	bulk.timestamp_ns = snapshot->timestamp_ns;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		bulk.values[i] = snapshot->fields[i].value;
+		if (!snapshot->fields[i].error)
+			bulk.valid |= BIT_ULL(i);
+	}
+	rcu_read_unlock();
+
+	this_cpu_inc(*devdri_data->cache_hits);
+
+	memcpy(buf, (char *)&bulk + off, count);
+	return count;
+}
+
+static const struct bin_attribute asus_primeb550plus_hwmon_bulk_attr = {
+	.attr = { .name = "all_sensors", .mode = 0444 },
+	.size = sizeof(struct asus_primeb550plus_hwmon_bulk),
+	.read = asus_primeb550plus_hwmon_bulk_read,
+};
+
+static const struct bin_attribute *const asus_primeb550plus_hwmon_bin_attrs[] = {
+	&asus_primeb550plus_hwmon_bulk_attr,
+	NULL
+};
+
+/* Builds the group of attributes the hwmon core does not know, for every present channel */
+static int asus_primeb550plus_hwmon_extra_attrs_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct asus_primeb550plus_hwmon_extra_attr *extra_attr;
+	size_t i, nr_attrs = 0;
+	unsigned int kind;
+	int channel;
+
+	for (i=0 ; i<ARRAY_SIZE(asus_primeb550plus_hwmon_type_descs) ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc = &asus_primeb550plus_hwmon_type_descs[i];
+
+		for (channel=0 ; channel<desc->nr_fields ; channel++)
+			if (devdri_data->present & BIT_ULL(desc->fields[channel]))
+				nr_attrs += hweight_long(ASUS_B550PLUS_HWMON_EXTRA_KINDS & ~desc->kinds);
+	}
+	if (devdri_data->writable)
+		nr_attrs += ASUS_B550PLUS_HWMON_PWM_OUTPUTS * (2 * ASUS_B550PLUS_HWMON_CURVE_POINTS + 1);
+
+	devdri_data->extra_attrs = devm_kcalloc(dev, nr_attrs, sizeof(*devdri_data->extra_attrs), GFP_KERNEL);
+	devdri_data->extra_attr_ptrs = devm_kcalloc(dev, nr_attrs + 1, sizeof(*devdri_data->extra_attr_ptrs), GFP_KERNEL);
+	if (!devdri_data->extra_attrs || !devdri_data->extra_attr_ptrs)
+		return -ENOMEM;
+
+	extra_attr = devdri_data->extra_attrs;
+	for (i=0 ; i<ARRAY_SIZE(asus_primeb550plus_hwmon_type_descs) ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc = &asus_primeb550plus_hwmon_type_descs[i];
+		unsigned long extra_kinds = ASUS_B550PLUS_HWMON_EXTRA_KINDS & ~desc->kinds;
+
+		for (channel=0 ; channel<desc->nr_fields ; channel++) {
+			if (!(devdri_data->present & BIT_ULL(desc->fields[channel])))
+				continue;
+			for_each_set_bit(kind, &extra_kinds, ASUS_B550PLUS_HWMON_ATTR_KIND_MAX) {
+				struct device_attribute *dev_attr = &extra_attr->sda.dev_attr;
+				umode_t mode = asus_primeb550plus_hwmon_kind_mode(kind);
+
+				snprintf(extra_attr->name, sizeof(extra_attr->name), "%s%d_%s", desc->name, channel + desc->index_base, asus_primeb550plus_hwmon_extra_attr_suffixes[kind]);
+				sysfs_attr_init(&dev_attr->attr);
+				dev_attr->attr.name = extra_attr->name;
+				dev_attr->attr.mode = mode;
+				dev_attr->show = mode & 0444 ? asus_primeb550plus_hwmon_extra_show : NULL;
+				dev_attr->store = mode & 0222 ? asus_primeb550plus_hwmon_extra_store : NULL;
+				extra_attr->sda.nr = kind;
+				extra_attr->sda.index = desc->fields[channel];
+
+				devdri_data->extra_attr_ptrs[extra_attr - devdri_data->extra_attrs] = &dev_attr->attr;
+				extra_attr++;
+			}
+		}
+	}
+
+	for (i=0 ; devdri_data->writable && i<ASUS_B550PLUS_HWMON_PWM_OUTPUTS ; i++) {
+		unsigned int n;
+
+		/* pwmN_auto_pointM_temp and pwmN_auto_pointM_pwm for every point, then pwmN_auto_temp_hyst */
+		for (n=0 ; n<2 * ASUS_B550PLUS_HWMON_CURVE_POINTS + 1 ; n++) {
+			struct device_attribute *dev_attr = &extra_attr->sda.dev_attr;
+			unsigned int const point = n / 2;
+
+			if (point == ASUS_B550PLUS_HWMON_CURVE_POINTS) {
+				snprintf(extra_attr->name, sizeof(extra_attr->name), "pwm%zu_auto_temp_hyst", i + 1);
+				extra_attr->sda.nr = ASUS_B550PLUS_HWMON_CURVE_HYST;
+			} else {
+				snprintf(extra_attr->name, sizeof(extra_attr->name), "pwm%zu_auto_point%u_%s", i + 1, point + 1, n % 2 ? "pwm" : "temp");
+				extra_attr->sda.nr = n % 2 ? ASUS_B550PLUS_HWMON_CURVE_POINT_PWM : ASUS_B550PLUS_HWMON_CURVE_POINT_TEMP;
+			}
+			extra_attr->sda.index = i * ASUS_B550PLUS_HWMON_CURVE_POINTS + point % ASUS_B550PLUS_HWMON_CURVE_POINTS;
+			sysfs_attr_init(&dev_attr->attr);
+			dev_attr->attr.name = extra_attr->name;
+			dev_attr->attr.mode = 0644;
+			dev_attr->show = asus_primeb550plus_hwmon_curve_show;
+			dev_attr->store = asus_primeb550plus_hwmon_curve_store;
+
+			devdri_data->extra_attr_ptrs[extra_attr - devdri_data->extra_attrs] = &dev_attr->attr;
+			extra_attr++;
+		}
+	}
+
+	devdri_data->extra_group.attrs = devdri_data->extra_attr_ptrs;
+	devdri_data->extra_group.bin_attrs = asus_primeb550plus_hwmon_bin_attrs;
+	devdri_data->extra_groups[0] = &devdri_data->extra_group;
+
+	return 0;
+}
+
+static const struct hwmon_ops asus_primeb550plus_hwmon_ops = {
+	.is_visible = asus_primeb550plus_hwmon_is_visible,
+	.read = asus_primeb550plus_hwmon_read,
+	.read_string = asus_primeb550plus_hwmon_read_string,
+	.write = asus_primeb550plus_hwmon_write,
+};
+
+#define ASUS_B550PLUS_HWMON_IN_CONFIG	(HWMON_I_INPUT | HWMON_I_LABEL | HWMON_I_MIN | HWMON_I_MAX | HWMON_I_CRIT | HWMON_I_ALARM | HWMON_I_MIN_ALARM | HWMON_I_MAX_ALARM | HWMON_I_CRIT_ALARM | HWMON_I_LOWEST | HWMON_I_HIGHEST | HWMON_I_AVERAGE | HWMON_I_RESET_HISTORY)
+#define ASUS_B550PLUS_HWMON_TEMP_CONFIG	(HWMON_T_INPUT | HWMON_T_LABEL | HWMON_T_MIN | HWMON_T_MAX | HWMON_T_CRIT | HWMON_T_ALARM | HWMON_T_MIN_ALARM | HWMON_T_MAX_ALARM | HWMON_T_CRIT_ALARM | HWMON_T_LOWEST | HWMON_T_HIGHEST | HWMON_T_RESET_HISTORY)
+#define ASUS_B550PLUS_HWMON_FAN_CONFIG	(HWMON_F_INPUT | HWMON_F_LABEL | HWMON_F_MIN | HWMON_F_MAX | HWMON_F_ALARM | HWMON_F_MIN_ALARM | HWMON_F_MAX_ALARM)
+#define ASUS_B550PLUS_HWMON_PWM_CONFIG	(HWMON_PWM_INPUT | HWMON_PWM_ENABLE | HWMON_PWM_AUTO_CHANNELS_TEMP)
+
+static const struct hwmon_channel_info *asus_primeb550plus_hwmon_info[] = {
+	HWMON_CHANNEL_INFO(chip, HWMON_C_UPDATE_INTERVAL | HWMON_C_IN_RESET_HISTORY | HWMON_C_TEMP_RESET_HISTORY),
+	HWMON_CHANNEL_INFO(in,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG,
+			   ASUS_B550PLUS_HWMON_IN_CONFIG, ASUS_B550PLUS_HWMON_IN_CONFIG),
+	HWMON_CHANNEL_INFO(temp,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG, ASUS_B550PLUS_HWMON_TEMP_CONFIG,
+			   ASUS_B550PLUS_HWMON_TEMP_CONFIG),
+	HWMON_CHANNEL_INFO(fan,
+			   ASUS_B550PLUS_HWMON_FAN_CONFIG, ASUS_B550PLUS_HWMON_FAN_CONFIG,
+			   ASUS_B550PLUS_HWMON_FAN_CONFIG, ASUS_B550PLUS_HWMON_FAN_CONFIG,
+			   ASUS_B550PLUS_HWMON_FAN_CONFIG, ASUS_B550PLUS_HWMON_FAN_CONFIG,
+			   ASUS_B550PLUS_HWMON_FAN_CONFIG),
+	HWMON_CHANNEL_INFO(pwm,
+			   ASUS_B550PLUS_HWMON_PWM_CONFIG, ASUS_B550PLUS_HWMON_PWM_CONFIG,
+			   ASUS_B550PLUS_HWMON_PWM_CONFIG, ASUS_B550PLUS_HWMON_PWM_CONFIG,
+			   ASUS_B550PLUS_HWMON_PWM_CONFIG, ASUS_B550PLUS_HWMON_PWM_CONFIG,
+			   ASUS_B550PLUS_HWMON_PWM_CONFIG),
+	NULL
+};
+
+static const struct hwmon_chip_info asus_primeb550plus_hwmon_chip_info = {
+	.ops = &asus_primeb550plus_hwmon_ops,
+	.info = asus_primeb550plus_hwmon_info,
+};
+
+/*
+ * Streaming interface: every open file of /dev/asus_hwmonN gets its own
+ * sampler, which pushes one asus_primeb550plus_hwmon_sample per period in
+ * a kfifo consumed by read()/poll().
+ */
+struct asus_primeb550plus_hwmon_stream {
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+	struct list_head node;
+	bool dead;
+
+	struct delayed_work work;
+	unsigned int period;	/* ms */
+	bool may_sweep;		/* opened by CAP_SYS_ADMIN, may be faster than the sampler */
+	u64 sequence;
+
+	struct mutex read_lock;
+	wait_queue_head_t wait;
+	DECLARE_KFIFO_PTR(fifo, struct asus_primeb550plus_hwmon_sample);
+};
+
+/* Protects streams lists and stream->dead, it must survive devices going away */
+static DEFINE_MUTEX(asus_primeb550plus_hwmon_streams_lock);
+static DEFINE_IDA(asus_primeb550plus_hwmon_ida);
+
+/* Other streams get the sampler's values, even when update_interval was raised after they set their period */
+static void asus_primeb550plus_hwmon_fill_sample(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned long max_age, bool may_sweep, struct asus_primeb550plus_hwmon_sample *sample)
+{
+	struct asus_primeb550plus_hwmon_snapshot const *snapshot;
+	bool stale = false;
+	size_t i;
+
+	BUILD_BUG_ON(ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS != ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+
+	rcu_read_lock();
+	if (may_sweep)
+		stale = time_after(jiffies, rcu_dereference(devdri_data->snapshot)->timestamp + msecs_to_jiffies(max_age));
+	rcu_read_unlock();
+
+	/* Faster than the sampler, sweep on our own */
+	if (stale)
+		asus_primeb550plus_hwmon_refresh(devdri_data, max_age);
+
+	rcu_read_lock();
+	snapshot = rcu_dereference(devdri_data->snapshot);
+	sample->timestamp_ns = snapshot->timestamp_ns;
+	sample->valid = 0;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		sample->values[i] = snapshot->fields[i].value;
+		if (!snapshot->fields[i].error)
+			sample->valid |= BIT_ULL(i);
+	}
+	rcu_read_unlock();
+}
+
+static void asus_primeb550plus_hwmon_stream_work(struct work_struct *work)
+{
+	struct asus_primeb550plus_hwmon_stream *stream = container_of(to_delayed_work(work), struct asus_primeb550plus_hwmon_stream, work);
+	struct asus_primeb550plus_hwmon_sample sample;
+	unsigned int period = READ_ONCE(stream->period);
+
+	asus_primeb550plus_hwmon_fill_sample(stream->devdri_data, period, stream->may_sweep, &sample);
+	sample.sequence = stream->sequence++;
+
+	/* A full fifo drops the new sample, readers see it as a sequence gap */
+	if (kfifo_put(&stream->fifo, sample))
+		wake_up_interruptible(&stream->wait);
+
+	queue_delayed_work(system_wq, &stream->work, msecs_to_jiffies(period));
+}
+
+static int asus_primeb550plus_hwmon_stream_open(struct inode *inode, struct file *file)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = container_of(file->private_data, struct asus_primeb550plus_hwmon_data, miscdev);
+	struct asus_primeb550plus_hwmon_stream *stream;
+	int err;
+
+	stream = kzalloc(sizeof(*stream), GFP_KERNEL);
+	if (!stream)
+		return -ENOMEM;
+
+	if ((err = kfifo_alloc(&stream->fifo, ASUS_B550PLUS_HWMON_STREAM_DEPTH, GFP_KERNEL))) {
+		kfree(stream);
+		return err;
+	}
+
+	stream->devdri_data = devdri_data;
+	stream->period = ASUS_B550PLUS_HWMON_STREAM_PERIOD_DEFAULT;
+	stream->may_sweep = capable(CAP_SYS_ADMIN);
+	mutex_init(&stream->read_lock);
+	init_waitqueue_head(&stream->wait);
+	INIT_DELAYED_WORK(&stream->work, asus_primeb550plus_hwmon_stream_work);
+
+	mutex_lock(&asus_primeb550plus_hwmon_streams_lock);
+	list_add(&stream->node, &devdri_data->streams);
+	mutex_unlock(&asus_primeb550plus_hwmon_streams_lock);
+
+	file->private_data = stream;
+	queue_delayed_work(system_wq, &stream->work, 0);
+
+	return stream_open(inode, file);
+}
+
+static int asus_primeb550plus_hwmon_stream_release(struct inode *inode, struct file *file)
+{
+	struct asus_primeb550plus_hwmon_stream *stream = file->private_data;
+
+	mutex_lock(&asus_primeb550plus_hwmon_streams_lock);
+	if (!stream->dead) {
+		list_del(&stream->node);
+		cancel_delayed_work_sync(&stream->work);
+	}
+	mutex_unlock(&asus_primeb550plus_hwmon_streams_lock);
+
+	kfifo_free(&stream->fifo);
+	kfree(stream);
+
+	return 0;
+}
+
+static ssize_t asus_primeb550plus_hwmon_stream_read(struct file *file, char __user *buf, size_t count, loff_t *ppos)
+{
+	struct asus_primeb550plus_hwmon_stream *stream = file->private_data;
+	unsigned int copied;
+	int err;
+
+	if (count < sizeof(struct asus_primeb550plus_hwmon_sample))
+		return -EINVAL;
+
+	if ((err = mutex_lock_interruptible(&stream->read_lock)))
+		return err;
+
+	while (kfifo_is_empty(&stream->fifo)) {
+		if (READ_ONCE(stream->dead)) {
+			err = -ENODEV;
+			goto out;
+		}
+		if (file->f_flags & O_NONBLOCK) {
+			err = -EAGAIN;
+			goto out;
+		}
+		if ((err = wait_event_interruptible(stream->wait, !kfifo_is_empty(&stream->fifo) || READ_ONCE(stream->dead))))
+			goto out;
+	}
+
+	err = kfifo_to_user(&stream->fifo, buf, count, &copied);
+
+out:
+	mutex_unlock(&stream->read_lock);
+	return err ? err : copied;
+}
+
+static __poll_t asus_primeb550plus_hwmon_stream_poll(struct file *file, poll_table *wait)
+{
+	struct asus_primeb550plus_hwmon_stream *stream = file->private_data;
+
+	poll_wait(file, &stream->wait, wait);
+
+	if (!kfifo_is_empty(&stream->fifo))
+		return EPOLLIN | EPOLLRDNORM;
+	if (READ_ONCE(stream->dead))
+		return EPOLLHUP | EPOLLERR;
+
+	return 0;
+}
+
+static long asus_primeb550plus_hwmon_stream_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+	struct asus_primeb550plus_hwmon_stream *stream = file->private_data;
+	__u32 __user *argp = (__u32 __user *)arg;
+	__u32 period;
+	long err;
+
+	switch(cmd) {
+		case ASUS_PRIMEB550PLUS_HWMON_IOC_SET_PERIOD:
+			if (get_user(period, argp))
+				return -EFAULT;
+			if (period < ASUS_B550PLUS_HWMON_STREAM_PERIOD_MIN || period > ASUS_B550PLUS_HWMON_STREAM_PERIOD_MAX)
+				return -EINVAL;
+
+			/* Until cut by miscdev_remove, which also takes streams_lock, devdri_data and work are there */
+			mutex_lock(&asus_primeb550plus_hwmon_streams_lock);
+			if (stream->dead) {
+				err = -ENODEV;
+			} else if (period < READ_ONCE(stream->devdri_data->update_interval) && !stream->may_sweep) {
+				/* Faster than the sampler means sweeping the chip */
+				err = -EPERM;
+			} else {
+				WRITE_ONCE(stream->period, period);
+				mod_delayed_work(system_wq, &stream->work, msecs_to_jiffies(period));
+				err = 0;
+			}
+			mutex_unlock(&asus_primeb550plus_hwmon_streams_lock);
+			return err;
+		case ASUS_PRIMEB550PLUS_HWMON_IOC_GET_PERIOD:
+			if (READ_ONCE(stream->dead))
+				return -ENODEV;
+			return put_user(READ_ONCE(stream->period), argp);
+		default:
+			return -ENOTTY;
+	}
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_stream_fops = {
+	.owner = THIS_MODULE,
+	.open = asus_primeb550plus_hwmon_stream_open,
+	.release = asus_primeb550plus_hwmon_stream_release,
+	.read = asus_primeb550plus_hwmon_stream_read,
+	.poll = asus_primeb550plus_hwmon_stream_poll,
+	.unlocked_ioctl = asus_primeb550plus_hwmon_stream_ioctl,
+	.compat_ioctl = compat_ptr_ioctl,
+};
+
+static void asus_primeb550plus_hwmon_miscdev_remove(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	struct asus_primeb550plus_hwmon_stream *stream, *tmp;
+
+	misc_deregister(&devdri_data->miscdev);
+
+	/* Files still open outlive the device, cut them from it */
+	mutex_lock(&asus_primeb550plus_hwmon_streams_lock);
+	list_for_each_entry_safe(stream, tmp, &devdri_data->streams, node) {
+		cancel_delayed_work_sync(&stream->work);
+		list_del(&stream->node);
+		WRITE_ONCE(stream->dead, true);
+		wake_up_interruptible(&stream->wait);
+	}
+	mutex_unlock(&asus_primeb550plus_hwmon_streams_lock);
+
+	ida_free(&asus_primeb550plus_hwmon_ida, devdri_data->instance);
+}
+
+static int asus_primeb550plus_hwmon_miscdev_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	int err;
+
+	INIT_LIST_HEAD(&devdri_data->streams);
+
+	if ((devdri_data->instance = ida_alloc(&asus_primeb550plus_hwmon_ida, GFP_KERNEL)) < 0)
+		return devdri_data->instance;
+
+	snprintf(devdri_data->miscdev_name, sizeof(devdri_data->miscdev_name), "asus_hwmon%d", devdri_data->instance);
+	devdri_data->miscdev.minor = MISC_DYNAMIC_MINOR;
+	devdri_data->miscdev.name = devdri_data->miscdev_name;
+	devdri_data->miscdev.fops = &asus_primeb550plus_hwmon_stream_fops;
+	devdri_data->miscdev.parent = dev;
+	devdri_data->miscdev.mode = 0444;
+
+	if ((err = misc_register(&devdri_data->miscdev))) {
+		ida_free(&asus_primeb550plus_hwmon_ida, devdri_data->instance);
+		return err;
+	}
+
+	return devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_miscdev_remove, devdri_data);
+}
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_IIO
+/*
+ * IIO frontend: every present channel is a scan channel
+ * (scan index is the field index), raw values are in hwmon units. Each
+ * trigger reads the enabled channels from the chip, the timestamp is
+ * taken when the trigger fires (the chip has none).
+ */
+struct asus_primeb550plus_hwmon_iio {
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+	struct {
+		s32 values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+		s64 timestamp __aligned(8);
+	} scan;
+};
+
+static int asus_primeb550plus_hwmon_iio_read_raw(struct iio_dev *indio_dev, struct iio_chan_spec const *chan, int *val, int *val2, long mask)
+{
+	struct asus_primeb550plus_hwmon_iio *iio = iio_priv(indio_dev);
+	long value;
+	int err;
+
+	switch(mask) {
+		case IIO_CHAN_INFO_RAW:
+			if ((err = asus_primeb550plus_hwmon_get_value(iio->devdri_data, chan->scan_index, &value)))
+				return err;
+			*val = value;
+			return IIO_VAL_INT;
+		case IIO_CHAN_INFO_SCALE:
+			switch(chan->type) {
+				case IIO_ANGL_VEL:
+					/* RPM to rad/s, 2 * pi / 60 */
+					*val = 0;
+					*val2 = 104719755;
+					return IIO_VAL_INT_PLUS_NANO;
+				default:
+					/* mV and m°C already */
+					*val = 1;
+					return IIO_VAL_INT;
+			}
+		default:
+			return -EINVAL;
+	}
+}
+
+static int asus_primeb550plus_hwmon_iio_read_label(struct iio_dev *indio_dev, struct iio_chan_spec const *chan, char *label)
+{
+	return sysfs_emit(label, "%s\n", asus_primeb550plus_hwmon_chip_fields[chan->scan_index]->label);
+}
+
+static const struct iio_info asus_primeb550plus_hwmon_iio_info = {
+	.read_raw = asus_primeb550plus_hwmon_iio_read_raw,
+	.read_label = asus_primeb550plus_hwmon_iio_read_label,
+};
+
+static irqreturn_t asus_primeb550plus_hwmon_iio_trigger_handler(int irq, void *p)
+{
+	struct iio_poll_func *pf = p;
+	struct iio_dev *indio_dev = pf->indio_dev;
+	struct asus_primeb550plus_hwmon_iio *iio = iio_priv(indio_dev);
+	struct asus_primeb550plus_hwmon_data *devdri_data = iio->devdri_data;
+	long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	u64 wanted = 0;
+	unsigned int bit, n = 0;
+
+	iio_for_each_active_channel(indio_dev, bit)
+		if (bit < ASUS_B550PLUS_HWMON_FIELD_LIST_MAX)
+			wanted |= BIT_ULL(bit);
+
+	mutex_lock(&devdri_data->update_lock);
+	asus_primeb550plus_hwmon_plan_read(devdri_data, wanted & devdri_data->present, values, errors);
+	/* A failed read (or an unconnected channel) repeats the last sweep */
+	for (bit=0 ; bit<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; bit++)
+		if (wanted & BIT_ULL(bit))
+			iio->scan.values[n++] = !(devdri_data->present & BIT_ULL(bit)) || errors[bit] ? devdri_data->values[bit] : values[bit];
+	mutex_unlock(&devdri_data->update_lock);
+
+	iio_push_to_buffers_with_timestamp(indio_dev, &iio->scan, pf->timestamp);
+	iio_trigger_notify_done(indio_dev->trig);
+
+	return IRQ_HANDLED;
+}
+
+static int asus_primeb550plus_hwmon_iio_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct asus_primeb550plus_hwmon_iio *iio;
+	struct iio_chan_spec *channels, *chan;
+	struct iio_dev *indio_dev;
+	size_t i;
+	int err;
+
+	indio_dev = devm_iio_device_alloc(dev, sizeof(*iio));
+	channels = devm_kcalloc(dev, hweight64(devdri_data->present) + 1, sizeof(*channels), GFP_KERNEL);
+	if (!indio_dev || !channels)
+		return -ENOMEM;
+
+	iio = iio_priv(indio_dev);
+	iio->devdri_data = devdri_data;
+
+	chan = channels;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc;
+		int channel;
+
+		if (!(devdri_data->present & BIT_ULL(i)))
+			continue;
+		if (!(desc = asus_primeb550plus_hwmon_field_channel(i, &channel)))
+			continue;
+
+		switch(desc->type) {
+			case hwmon_in:
+				chan->type = IIO_VOLTAGE;
+				break;
+			case hwmon_temp:
+				chan->type = IIO_TEMP;
+				break;
+			default:
+				chan->type = IIO_ANGL_VEL;
+				break;
+		}
+		/* Same numbering as hwmon */
+		chan->indexed = 1;
+		chan->channel = channel + desc->index_base;
+		chan->info_mask_separate = BIT(IIO_CHAN_INFO_RAW);
+		chan->info_mask_shared_by_type = BIT(IIO_CHAN_INFO_SCALE);
+		chan->scan_index = i;
+		chan->scan_type.sign = 's';
+		chan->scan_type.realbits = 32;
+		chan->scan_type.storagebits = 32;
+		chan->scan_type.endianness = IIO_CPU;
+		chan++;
+	}
+	*chan++ = (struct iio_chan_spec)IIO_CHAN_SOFT_TIMESTAMP(ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+
+	indio_dev->name = "asus_primeb550plus_hwmon";
+	indio_dev->info = &asus_primeb550plus_hwmon_iio_info;
+	indio_dev->modes = INDIO_DIRECT_MODE;
+	indio_dev->channels = channels;
+	indio_dev->num_channels = chan - channels;
+
+	if ((err = devm_iio_triggered_buffer_setup(dev, indio_dev, iio_pollfunc_store_time, asus_primeb550plus_hwmon_iio_trigger_handler, NULL)))
+		return err;
+
+	return devm_iio_device_register(dev, indio_dev);
+}
+#endif
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+/*
+ * perf PMU: one event per present channel, config is the
+ * field index. Sensors give levels, not counts, so an event counts the
+ * integral of its channel over time (unit.ms, scaled to unit.s): the
+ * delta over an interval divided by its length is the average. Reads
+ * take the values of the last sweep and never block (they may come from
+ * NMI context). The chip is shared by every CPU, events all count on
+ * one, and move to another when it goes offline.
+ */
+struct asus_primeb550plus_hwmon_pmu_attr {
+	struct device_attribute dev_attr;
+	char name[48];
+	char value[24];
+};
+
+PMU_FORMAT_ATTR(channel, "config:0-7");
+
+static struct attribute *asus_primeb550plus_hwmon_pmu_format_attrs[] = {
+	&format_attr_channel.attr,
+	NULL
+};
+
+static const struct attribute_group asus_primeb550plus_hwmon_pmu_format_group = {
+	.name = "format",
+	.attrs = asus_primeb550plus_hwmon_pmu_format_attrs,
+};
+
+static ssize_t asus_primeb550plus_hwmon_pmu_cpumask_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct pmu *pmu = dev_get_drvdata(dev);
+	struct asus_primeb550plus_hwmon_data *devdri_data = container_of(pmu, struct asus_primeb550plus_hwmon_data, pmu);
+
+	return cpumap_print_to_pagebuf(true, buf, cpumask_of(READ_ONCE(devdri_data->pmu_cpu)));
+}
+static DEVICE_ATTR(cpumask, 0444, asus_primeb550plus_hwmon_pmu_cpumask_show, NULL);
+
+static struct attribute *asus_primeb550plus_hwmon_pmu_cpumask_attrs[] = {
+	&dev_attr_cpumask.attr,
+	NULL
+};
+
+static const struct attribute_group asus_primeb550plus_hwmon_pmu_cpumask_group = {
+	.attrs = asus_primeb550plus_hwmon_pmu_cpumask_attrs,
+};
+
+static ssize_t asus_primeb550plus_hwmon_pmu_attr_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct asus_primeb550plus_hwmon_pmu_attr const *pmu_attr = container_of(attr, struct asus_primeb550plus_hwmon_pmu_attr, dev_attr);
+
+	return sysfs_emit(buf, "%s\n", pmu_attr->value);
+}
+
+static void asus_primeb550plus_hwmon_pmu_attr_init(struct asus_primeb550plus_hwmon_pmu_attr *pmu_attr, const char *event, const char *suffix, const char *value)
+{
+	snprintf(pmu_attr->name, sizeof(pmu_attr->name), "%s%s", event, suffix);
+	strscpy(pmu_attr->value, value, sizeof(pmu_attr->value));
+	sysfs_attr_init(&pmu_attr->dev_attr.attr);
+	pmu_attr->dev_attr.attr.name = pmu_attr->name;
+	pmu_attr->dev_attr.attr.mode = 0444;
+	pmu_attr->dev_attr.show = asus_primeb550plus_hwmon_pmu_attr_show;
+}
+
+/* Labels that are a plain word (cpuvcore, sysfan...) name events too, cpu is a perf term */
+static bool asus_primeb550plus_hwmon_pmu_alias_ok(const char *label)
+{
+	if (!strcmp(label, "cpu"))
+		return false;
+
+	for ( ; *label ; label++)
+		if (!islower(*label) && !isdigit(*label))
+			return false;
+
+	return true;
+}
+
+static struct asus_primeb550plus_hwmon_data *asus_primeb550plus_hwmon_pmu_data(struct perf_event *event)
+{
+	return container_of(event->pmu, struct asus_primeb550plus_hwmon_data, pmu);
+}
+
+static int asus_primeb550plus_hwmon_pmu_event_init(struct perf_event *event)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+
+	if (event->attr.type != event->pmu->type)
+		return -ENOENT;
+
+	devdri_data = asus_primeb550plus_hwmon_pmu_data(event);
+
+	/* Counting only, system wide */
+	if (is_sampling_event(event) || event->cpu < 0)
+		return -EINVAL;
+	if (event->attr.config >= ASUS_B550PLUS_HWMON_FIELD_LIST_MAX || !(READ_ONCE(devdri_data->present) & BIT_ULL(event->attr.config)))
+		return -EINVAL;
+
+	event->cpu = READ_ONCE(devdri_data->pmu_cpu);
+
+	return 0;
+}
+
+/* Adds the value of the last sweep times the time since the previous update */
+static void asus_primeb550plus_hwmon_pmu_update(struct perf_event *event)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_pmu_data(event);
+	struct asus_primeb550plus_hwmon_snapshot const *snapshot;
+	u64 const now = ktime_get_mono_fast_ns();
+	u64 const prev = local64_xchg(&event->hw.prev_count, now);
+	long value;
+	int err;
+
+	rcu_read_lock();
+	snapshot = rcu_dereference(devdri_data->snapshot);
+	err = snapshot->fields[event->attr.config].error;
+	value = snapshot->fields[event->attr.config].value;
+	rcu_read_unlock();
+
+	/* Values are being read, keeps a low_wakeup sampler at update_interval */
+	if (low_wakeup && READ_ONCE(devdri_data->last_consumed) != jiffies)
+		WRITE_ONCE(devdri_data->last_consumed, jiffies);
+
+	/* Failed reads and values below 0 count as 0, the product needs 128 bits after about two days */
+	if (!err && value > 0)
+		local64_add(mul_u64_u64_div_u64(now - prev, value, NSEC_PER_MSEC), &event->count);
+}
+
+static void asus_primeb550plus_hwmon_pmu_start(struct perf_event *event, int flags)
+{
+	local64_set(&event->hw.prev_count, ktime_get_mono_fast_ns());
+	event->hw.state = 0;
+}
+
+static void asus_primeb550plus_hwmon_pmu_stop(struct perf_event *event, int flags)
+{
+	if (event->hw.state & PERF_HES_STOPPED)
+		return;
+
+	asus_primeb550plus_hwmon_pmu_update(event);
+	event->hw.state = PERF_HES_STOPPED | PERF_HES_UPTODATE;
+}
+
+static int asus_primeb550plus_hwmon_pmu_add(struct perf_event *event, int flags)
+{
+	event->hw.state = PERF_HES_STOPPED | PERF_HES_UPTODATE;
+	if (flags & PERF_EF_START)
+		asus_primeb550plus_hwmon_pmu_start(event, PERF_EF_RELOAD);
+
+	return 0;
+}
+
+static void asus_primeb550plus_hwmon_pmu_del(struct perf_event *event, int flags)
+{
+	asus_primeb550plus_hwmon_pmu_stop(event, PERF_EF_UPDATE);
+}
+
+static void asus_primeb550plus_hwmon_pmu_read(struct perf_event *event)
+{
+	asus_primeb550plus_hwmon_pmu_update(event);
+}
+
+static void asus_primeb550plus_hwmon_pmu_remove(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	perf_pmu_unregister(&devdri_data->pmu);
+}
+
+/* Set up at module init, one instance per PMU */
+static enum cpuhp_state asus_primeb550plus_hwmon_pmu_hp_state = CPUHP_INVALID;
+
+/* Events move along with pmu_cpu, as for uncore PMUs */
+static int asus_primeb550plus_hwmon_pmu_cpu_offline(unsigned int cpu, struct hlist_node *node)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = hlist_entry_safe(node, struct asus_primeb550plus_hwmon_data, pmu_node);
+	unsigned int target;
+
+	if (cpu != devdri_data->pmu_cpu)
+		return 0;
+
+	target = cpumask_any_but(cpu_online_mask, cpu);
+	if (target >= nr_cpu_ids)
+		return 0;
+
+	perf_pmu_migrate_context(&devdri_data->pmu, cpu, target);
+	WRITE_ONCE(devdri_data->pmu_cpu, target);
+
+	return 0;
+}
+
+static void asus_primeb550plus_hwmon_pmu_hp_remove(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	cpuhp_state_remove_instance_nocalls(asus_primeb550plus_hwmon_pmu_hp_state, &devdri_data->pmu_node);
+}
+
+static int asus_primeb550plus_hwmon_pmu_hp_init(void)
+{
+	int ret;
+
+	ret = cpuhp_setup_state_multi(CPUHP_AP_ONLINE_DYN, "hwmon/asus_primeb550plus_hwmon:online", NULL, asus_primeb550plus_hwmon_pmu_cpu_offline);
+	if (ret < 0)
+		return ret;
+	asus_primeb550plus_hwmon_pmu_hp_state = ret;
+
+	return 0;
+}
+
+static void asus_primeb550plus_hwmon_pmu_hp_exit(void)
+{
+	cpuhp_remove_multi_state(asus_primeb550plus_hwmon_pmu_hp_state);
+}
+
+/* asus_hwmon for the first instance, asus_hwmonN for the others */
+static int asus_primeb550plus_hwmon_pmu_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	/* event, .scale and .unit, under the hwmon name and maybe the label */
+	size_t const max_attrs = hweight64(devdri_data->present) * 2 * 3;
+	struct asus_primeb550plus_hwmon_pmu_attr *pmu_attr;
+	size_t i, n;
+	int err;
+
+	devdri_data->pmu_attrs = devm_kcalloc(dev, max_attrs, sizeof(*devdri_data->pmu_attrs), GFP_KERNEL);
+	devdri_data->pmu_attr_ptrs = devm_kcalloc(dev, max_attrs + 1, sizeof(*devdri_data->pmu_attr_ptrs), GFP_KERNEL);
+	if (!devdri_data->pmu_attrs || !devdri_data->pmu_attr_ptrs)
+		return -ENOMEM;
+
+	pmu_attr = devdri_data->pmu_attrs;
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		const char * const label = asus_primeb550plus_hwmon_chip_fields[i]->label;
+		const struct asus_primeb550plus_hwmon_type_desc *desc;
+		char names[2][32], config[24], unit[24];
+		size_t nr_names = 1;
+		int channel;
+
+		if (!(devdri_data->present & BIT_ULL(i)))
+			continue;
+		if (!(desc = asus_primeb550plus_hwmon_field_channel(i, &channel)))
+			continue;
+
+		snprintf(names[0], sizeof(names[0]), "%s%d", desc->name, channel + desc->index_base);
+		if (strcmp(label, names[0]) && asus_primeb550plus_hwmon_pmu_alias_ok(label))
+			strscpy(names[nr_names++], label, sizeof(names[0]));
+
+		snprintf(config, sizeof(config), "channel=%zu", i);
+		snprintf(unit, sizeof(unit), "%s.s", desc->unit);
+		for (n=0 ; n<nr_names ; n++) {
+			asus_primeb550plus_hwmon_pmu_attr_init(pmu_attr++, names[n], "", config);
+			asus_primeb550plus_hwmon_pmu_attr_init(pmu_attr++, names[n], ".scale", desc->milli ? "1e-6" : "1e-3");
+			asus_primeb550plus_hwmon_pmu_attr_init(pmu_attr++, names[n], ".unit", unit);
+		}
+	}
+	for (i=0 ; i<pmu_attr - devdri_data->pmu_attrs ; i++)
+		devdri_data->pmu_attr_ptrs[i] = &devdri_data->pmu_attrs[i].dev_attr.attr;
+
+	devdri_data->pmu_events_group.name = "events";
+	devdri_data->pmu_events_group.attrs = devdri_data->pmu_attr_ptrs;
+	devdri_data->pmu_groups[0] = &asus_primeb550plus_hwmon_pmu_format_group;
+	devdri_data->pmu_groups[1] = &devdri_data->pmu_events_group;
+	devdri_data->pmu_groups[2] = &asus_primeb550plus_hwmon_pmu_cpumask_group;
+
+	if (devdri_data->instance)
+		snprintf(devdri_data->pmu_name, sizeof(devdri_data->pmu_name), "asus_hwmon%d", devdri_data->instance);
+	else
+		strscpy(devdri_data->pmu_name, "asus_hwmon", sizeof(devdri_data->pmu_name));
+
+	devdri_data->pmu = (struct pmu) {
+		.module = THIS_MODULE,
+		.attr_groups = devdri_data->pmu_groups,
+		.task_ctx_nr = perf_invalid_context,
+		.capabilities = PERF_PMU_CAP_NO_EXCLUDE | PERF_PMU_CAP_NO_INTERRUPT,
+		.event_init = asus_primeb550plus_hwmon_pmu_event_init,
+		.add = asus_primeb550plus_hwmon_pmu_add,
+		.del = asus_primeb550plus_hwmon_pmu_del,
+		.start = asus_primeb550plus_hwmon_pmu_start,
+		.stop = asus_primeb550plus_hwmon_pmu_stop,
+		.read = asus_primeb550plus_hwmon_pmu_read,
+	};
+
+	/* No CPU may go offline between picking pmu_cpu and watching it */
+	cpus_read_lock();
+	devdri_data->pmu_cpu = cpumask_first(cpu_online_mask);
+	err = cpuhp_state_add_instance_nocalls_cpuslocked(asus_primeb550plus_hwmon_pmu_hp_state, &devdri_data->pmu_node);
+	cpus_read_unlock();
+	if (err)
+		return err;
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_pmu_hp_remove, devdri_data)))
+		return err;
+
+	if ((err = perf_pmu_register(&devdri_data->pmu, devdri_data->pmu_name, -1)))
+		return err;
+
+	return devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_pmu_remove, devdri_data);
+}
+#endif
+
+static void asus_primeb550plus_hwmon_limits_init(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		struct asus_primeb550plus_hwmon_limits *limits = &devdri_data->limits[i];
+
+		asus_primeb550plus_hwmon_field_range(asus_primeb550plus_hwmon_chip_fields[i], &limits->min, &limits->max);
+		limits->crit = limits->max;
+		devdri_data->history[i].average_interval = ASUS_B550PLUS_HWMON_AVERAGE_INTERVAL_DEFAULT;
+	}
+}
+
+/* Every output left to the chip, curves follow the PCH CPU temperature */
+static void asus_primeb550plus_hwmon_fan_curves_init(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	int channel;
+	size_t i;
+
+	asus_primeb550plus_hwmon_field_channel(ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP, &channel);
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_PWM_OUTPUTS ; i++) {
+		struct asus_primeb550plus_hwmon_fan_curve *curve = &devdri_data->fan_curves[i];
+
+		curve->enable = ASUS_B550PLUS_HWMON_PWM_CHIP;
+		curve->temp_channels = BIT(channel);
+		memcpy(curve->point_temps, asus_primeb550plus_hwmon_curve_default_temps, sizeof(curve->point_temps));
+		memcpy(curve->point_pwms, asus_primeb550plus_hwmon_curve_default_pwms, sizeof(curve->point_pwms));
+		curve->hyst = ASUS_B550PLUS_HWMON_CURVE_HYST_DEFAULT;
+	}
+}
+
+/* Hands every output back to the chip, once nothing can take them anymore */
+static void asus_primeb550plus_hwmon_fan_curves_stop(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	size_t i;
+
+	mutex_lock(&devdri_data->update_lock);
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_PWM_OUTPUTS ; i++) {
+		asus_primeb550plus_hwmon_pwm_release(devdri_data, i);
+		devdri_data->fan_curves[i].enable = ASUS_B550PLUS_HWMON_PWM_CHIP;
+	}
+	mutex_unlock(&devdri_data->update_lock);
+}
+
+static void asus_primeb550plus_hwmon_archive_free(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	kvfree(devdri_data->archive.blocks);
+}
+
+static int asus_primeb550plus_hwmon_archive_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	unsigned int nr_blocks;
+
+	BUILD_BUG_ON(sizeof(struct asus_primeb550plus_hwmon_archive_block) != ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_BLOCK_SIZE);
+
+	if (archive_size > ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_MAX)
+		dev_warn(dev, "archive_size %u KiB too large, using %u KiB\n", archive_size, ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_MAX);
+	nr_blocks = min_t(unsigned int, archive_size, ASUS_B550PLUS_HWMON_ARCHIVE_SIZE_MAX) / (sizeof(struct asus_primeb550plus_hwmon_archive_block) / 1024);
+	if (!nr_blocks)
+		return 0;
+
+	devdri_data->archive.blocks = kvcalloc(nr_blocks, sizeof(*devdri_data->archive.blocks), GFP_KERNEL);
+	if (!devdri_data->archive.blocks)
+		return -ENOMEM;
+	devdri_data->archive.nr_blocks = nr_blocks;
+
+	return devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_archive_free, devdri_data);
+}
+
+static void asus_primeb550plus_hwmon_raw_trace_free(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	kvfree(devdri_data->raw_trace.records);
+}
+
+static void asus_primeb550plus_hwmon_snapshot_free(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	kfree(rcu_dereference_protected(devdri_data->snapshot, true));
+}
+
+static int asus_primeb550plus_hwmon_check_dmi(void)
+{
+	if (dmi_check_system(asus_accepted_dmis))
+		return 0;
+	
+	return -ENODEV;
+}
+
+static int asus_primeb550plus_hwmon_get_method_handles(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct device *dev = &devdri_data->acpi_dev->dev;
+	acpi_handle a_hndl;
+	acpi_status a_status;
+	acpi_object_type a_type;
+
+	a_status = acpi_get_handle(devdri_data->acpi_dev_handle, "RHWM", &a_hndl);
+	if (ACPI_SUCCESS(a_status)) {
+		devdri_data->rhwm_method = a_hndl;
+	} else {
+		dev_err(dev, "method RHWM not found: %s\n", acpi_format_exception(a_status));
+		return -ENODEV;
+	}
+
+	a_status = acpi_get_type(devdri_data->rhwm_method, &a_type);
+	if (!ACPI_SUCCESS(a_status)) {
+		dev_err(dev, "Could not figure out acpi object type: %s\n", acpi_format_exception(a_status));
+		return -EIO;
+	}
+	if (a_type != ACPI_TYPE_METHOD) {
+		dev_err(dev, "RHWM found, but is not a method\n");
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+#define ASUS_B550PLUS_HWMON_VENDOR_ID_BANK 0
+#define ASUS_B550PLUS_HWMON_VENDOR_ID_INDEX 0x4f
+#define ASUS_B550PLUS_HWMON_CHIP_ID_BANK 0
+#define ASUS_B550PLUS_HWMON_CHIP_ID_INDEX 0x58
+
+struct asus_primeb550plus_hwmon_supported_superio {
+	unsigned char vendor_id_high;
+	unsigned char chip_id;
+};
+
+static const struct asus_primeb550plus_hwmon_supported_superio asus_primeb550plus_hwmon_supported_superios[] = {
+	{ .vendor_id_high = 0x5c, .chip_id = 0xc1 },
+};
+
+static int asus_primeb550plus_hwmon_check_chip(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	size_t i;
+	unsigned char vendor_id_high, chip_id;
+
+	if (asus_primeb550plus_hwmon_read_u8(devdri_data, ASUS_B550PLUS_HWMON_VENDOR_ID_BANK, ASUS_B550PLUS_HWMON_VENDOR_ID_INDEX, &vendor_id_high))
+		goto err_read;
+	if (asus_primeb550plus_hwmon_read_u8(devdri_data, ASUS_B550PLUS_HWMON_CHIP_ID_BANK, ASUS_B550PLUS_HWMON_CHIP_ID_INDEX, &chip_id))
+		goto err_read;
+
+	for (i=0 ; i<sizeof(asus_primeb550plus_hwmon_supported_superios)/sizeof(asus_primeb550plus_hwmon_supported_superios[0]) ; i++) {
+		struct asus_primeb550plus_hwmon_supported_superio const * const chip = &asus_primeb550plus_hwmon_supported_superios[i];
+
+		if (vendor_id_high == chip->vendor_id_high && chip_id == chip->chip_id) {
+			dev_info(dev, "Found chip vendor_id=0x%02x, chip_id=0x%02x\n", vendor_id_high , chip_id);
+			return 0;
+		}
+	}
+
+	dev_info(dev, "Unknown chip vendor_id=0x%02x, chip_id=0x%02x\n", vendor_id_high, chip_id);
+	return 1;
+
+err_read:
+	dev_info(dev, "Error while reading vendor/chip id\n");
+	return 1;
+}
+
+static int asus_primeb550plus_hwmon_cache_hits_get(void *data, u64 *val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	int cpu;
+
+	*val = 0;
+	for_each_possible_cpu(cpu)
+		*val += *per_cpu_ptr(devdri_data->cache_hits, cpu);
+
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(asus_primeb550plus_hwmon_cache_hits_fops, asus_primeb550plus_hwmon_cache_hits_get, NULL, "%llu\n");
+
+static int asus_primeb550plus_hwmon_backend_calls_get(void *data, u64 *val)
+{
+	*val = asus_primeb550plus_hwmon_backend_calls(data);
+
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(asus_primeb550plus_hwmon_backend_calls_fops, asus_primeb550plus_hwmon_backend_calls_get, NULL, "%llu\n");
+
+static int asus_primeb550plus_hwmon_backend_errors_get(void *data, u64 *val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	int cpu;
+
+	*val = 0;
+	for_each_possible_cpu(cpu)
+		*val += per_cpu_ptr(devdri_data->backend_stats, cpu)->errors;
+
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(asus_primeb550plus_hwmon_backend_errors_fops, asus_primeb550plus_hwmon_backend_errors_get, NULL, "%llu\n");
+
+/* One line per non-empty bucket: "bank <n> <low>-<high>ns <count>" */
+static int asus_primeb550plus_hwmon_latency_show(struct seq_file *s, void *unused)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = s->private;
+	size_t bank, bucket;
+	int cpu;
+
+	for (bank=0 ; bank<ASUS_B550PLUS_HWMON_LATENCY_BANKS ; bank++) {
+		for (bucket=0 ; bucket<ASUS_B550PLUS_HWMON_LATENCY_BUCKETS ; bucket++) {
+			u64 count = 0;
+
+			for_each_possible_cpu(cpu)
+				count += per_cpu_ptr(devdri_data->backend_stats, cpu)->latency[bank][bucket];
+
+			if (!count)
+				continue;
+
+			if (bucket == ASUS_B550PLUS_HWMON_LATENCY_BUCKETS - 1)
+				seq_printf(s, "bank %zu %llu-ns %llu\n", bank, 1ULL << (bucket - 1), count);
+			else
+				seq_printf(s, "bank %zu %llu-%lluns %llu\n", bank, bucket ? 1ULL << (bucket - 1) : 0, (1ULL << bucket) - 1, count);
+		}
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(asus_primeb550plus_hwmon_latency);
+
+/*
+ * One line per bank that ever failed:
+ * "bank <n> <closed|open|half-open> <consecutive failures> <errors> <trips> <rejected> <backoff ms>"
+ */
+static int asus_primeb550plus_hwmon_breakers_show(struct seq_file *s, void *unused)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = s->private;
+	size_t bank;
+
+	mutex_lock(&devdri_data->update_lock);
+	for (bank=0 ; bank<ASUS_B550PLUS_HWMON_BREAKER_BANKS ; bank++) {
+		struct asus_primeb550plus_hwmon_breaker const * const breaker = &devdri_data->breakers[bank];
+		const char *state = "closed";
+
+		if (!breaker->errors)
+			continue;
+		if (breaker->backoff)
+			state = time_before(jiffies, breaker->retry_at) ? "open" : "half-open";
+
+		seq_printf(s, "bank %zu %s %u %llu %llu %llu %u\n", bank, state, breaker->failures, breaker->errors, breaker->trips, breaker->rejected, breaker->backoff);
+	}
+	mutex_unlock(&devdri_data->update_lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(asus_primeb550plus_hwmon_breakers);
+
+/* One line per channel: "<channel> <interval ms> <rate class> <label>" */
+static int asus_primeb550plus_hwmon_intervals_show(struct seq_file *s, void *unused)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = s->private;
+	const struct asus_primeb550plus_hwmon_type_desc *desc;
+	int channel;
+	size_t i;
+
+	mutex_lock(&devdri_data->update_lock);
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		if (!(desc = asus_primeb550plus_hwmon_field_channel(i, &channel)))
+			continue;
+		seq_printf(s, "%s%d %u %u %s\n", desc->name, channel + desc->index_base, devdri_data->schedule[i].interval, devdri_data->schedule[i].rate_class, asus_primeb550plus_hwmon_chip_fields[i]->label);
+	}
+	mutex_unlock(&devdri_data->update_lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(asus_primeb550plus_hwmon_intervals);
+
+#define ASUS_B550PLUS_HWMON_BENCH_ITERATIONS 100
+
+/*
+ * Times single reads (first field) and full sweeps straight from the
+ * backend, bypassing the snapshot. Producer state is left untouched.
+ * Must be called with update_lock held.
+ */
+static void asus_primeb550plus_hwmon_bench_backend(struct seq_file *s, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	u64 read_ns, sweep_ns, read_calls, sweep_calls;
+	long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	unsigned int failures = 0;
+	size_t i, j;
+	u64 start;
+
+	read_calls = asus_primeb550plus_hwmon_backend_calls(devdri_data);
+	start = ktime_get_ns();
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_BENCH_ITERATIONS ; i++)
+		if (asus_primeb550plus_hwmon_read_field(devdri_data, asus_primeb550plus_hwmon_chip_fields[0], &values[0]))
+			failures++;
+	read_ns = ktime_get_ns() - start;
+	read_calls = asus_primeb550plus_hwmon_backend_calls(devdri_data) - read_calls;
+
+	sweep_calls = asus_primeb550plus_hwmon_backend_calls(devdri_data);
+	start = ktime_get_ns();
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_BENCH_ITERATIONS ; i++) {
+		asus_primeb550plus_hwmon_plan_read(devdri_data, ASUS_B550PLUS_HWMON_ALL_FIELDS, values, errors);
+		for (j=0 ; j<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; j++)
+			if (errors[j])
+				failures++;
+	}
+	sweep_ns = ktime_get_ns() - start;
+	sweep_calls = asus_primeb550plus_hwmon_backend_calls(devdri_data) - sweep_calls;
+
+	seq_printf(s, "backend %s\n", devdri_data->backend->name);
+	seq_printf(s, "iterations %u\n", ASUS_B550PLUS_HWMON_BENCH_ITERATIONS);
+	seq_printf(s, "read_ns %llu\n", div_u64(read_ns, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "read_backend_calls %llu\n", div_u64(read_calls, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "sweep_ns %llu\n", div_u64(sweep_ns, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "sweep_backend_calls %llu\n", div_u64(sweep_calls, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "failures %u\n", failures);
+}
+
+/*
+ * Times the registers of the first field, then every register of the read
+ * plan, through the RHWM method directly: the bound backend, its breakers,
+ * statistics and raw trace are not involved. Must be called with
+ * update_lock held.
+ */
+static void asus_primeb550plus_hwmon_bench_rhwm(struct seq_file *s, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct asus_primeb550plus_hwmon_backend_ops const * const ops = &asus_primeb550plus_hwmon_rhwm_backend;
+	struct asus_primeb550plus_hwmon_read_plan const * const plan = &devdri_data->plan;
+	unsigned char banks[2], indexes[2], value;
+	unsigned int failures = 0, nr_regs;
+	u64 read_ns, sweep_ns;
+	size_t i, j;
+	u64 start;
+
+	nr_regs = asus_primeb550plus_hwmon_field_registers(asus_primeb550plus_hwmon_chip_fields[0], banks, indexes);
+	start = ktime_get_ns();
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_BENCH_ITERATIONS ; i++)
+		for (j=0 ; j<nr_regs ; j++)
+			if (ops->read_u8(devdri_data, banks[j], indexes[j], &value))
+				failures++;
+	read_ns = ktime_get_ns() - start;
+
+	start = ktime_get_ns();
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_BENCH_ITERATIONS ; i++)
+		for (j=0 ; j<plan->nr_slots ; j++)
+			if (ops->read_u8(devdri_data, plan->banks[j], plan->indexes[j], &value))
+				failures++;
+	sweep_ns = ktime_get_ns() - start;
+
+	seq_printf(s, "backend %s\n", ops->name);
+	seq_printf(s, "iterations %u\n", ASUS_B550PLUS_HWMON_BENCH_ITERATIONS);
+	seq_printf(s, "read_ns %llu\n", div_u64(read_ns, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "read_backend_calls %u\n", nr_regs);
+	seq_printf(s, "sweep_ns %llu\n", div_u64(sweep_ns, ASUS_B550PLUS_HWMON_BENCH_ITERATIONS));
+	seq_printf(s, "sweep_backend_calls %u\n", plan->nr_slots);
+	seq_printf(s, "failures %u\n", failures);
+}
+
+/* Bound backend, then RHWM for comparison when another one is bound */
+static int asus_primeb550plus_hwmon_bench_show(struct seq_file *s, void *unused)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = s->private;
+
+	mutex_lock(&devdri_data->update_lock);
+
+	asus_primeb550plus_hwmon_bench_backend(s, devdri_data);
+
+	if (devdri_data->rhwm_method && devdri_data->backend != &asus_primeb550plus_hwmon_rhwm_backend) {
+		seq_putc(s, '\n');
+		asus_primeb550plus_hwmon_bench_rhwm(s, devdri_data);
+	}
+
+	mutex_unlock(&devdri_data->update_lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(asus_primeb550plus_hwmon_bench);
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+/* Dumps non-zero registers as "bank index value", accepts the same to set one */
+static int asus_primeb550plus_hwmon_registers_show(struct seq_file *s, void *unused)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = s->private;
+	struct asus_primeb550plus_hwmon_emulated const * const emulated = devdri_data->emulated;
+	size_t bank, index;
+
+	for (bank=0 ; bank<ASUS_B550PLUS_HWMON_EMULATED_BANKS ; bank++)
+		for (index=0 ; index<256 ; index++)
+			if (emulated->regs[bank][index])
+				seq_printf(s, "%zu 0x%02zx 0x%02x\n", bank, index, emulated->regs[bank][index]);
+
+	return 0;
+}
+
+static int asus_primeb550plus_hwmon_registers_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, asus_primeb550plus_hwmon_registers_show, inode->i_private);
+}
+
+static ssize_t asus_primeb550plus_hwmon_registers_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = ((struct seq_file *)file->private_data)->private;
+	struct asus_primeb550plus_hwmon_emulated * const emulated = devdri_data->emulated;
+	unsigned int bank, index, value;
+	char kbuf[32];
+
+	if (count >= sizeof(kbuf))
+		return -EINVAL;
+	if (copy_from_user(kbuf, buf, count))
+		return -EFAULT;
+	kbuf[count] = '\0';
+
+	if (sscanf(kbuf, "%i %i %i", &bank, &index, &value) != 3)
+		return -EINVAL;
+	if (bank >= ASUS_B550PLUS_HWMON_EMULATED_BANKS || index > U8_MAX || value > U8_MAX)
+		return -EINVAL;
+
+	WRITE_ONCE(emulated->regs[bank][index], value);
+	asus_primeb550plus_hwmon_presence_recheck(devdri_data);
+
+	return count;
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_registers_fops = {
+	.owner = THIS_MODULE,
+	.open = asus_primeb550plus_hwmon_registers_open,
+	.read = seq_read,
+	.write = asus_primeb550plus_hwmon_registers_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+#endif
+
+static int asus_primeb550plus_hwmon_raw_trace_enable_get(void *data, u64 *val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	*val = READ_ONCE(devdri_data->raw_trace.enabled);
+
+	return 0;
+}
+
+/* Enabling starts a new recording */
+static int asus_primeb550plus_hwmon_raw_trace_enable_set(void *data, u64 val)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	int err = 0;
+
+	mutex_lock(&devdri_data->update_lock);
+
+	if (!val) {
+		devdri_data->raw_trace.enabled = false;
+	} else if (!devdri_data->raw_trace.records && !(devdri_data->raw_trace.records = kvcalloc(ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS, sizeof(*devdri_data->raw_trace.records), GFP_KERNEL))) {
+		err = -ENOMEM;
+	} else {
+		devdri_data->raw_trace.head = 0;
+		devdri_data->raw_trace.start_ns = ktime_get_ns();
+		devdri_data->raw_trace.enabled = true;
+	}
+
+	mutex_unlock(&devdri_data->update_lock);
+
+	return err;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(asus_primeb550plus_hwmon_raw_trace_enable_fops, asus_primeb550plus_hwmon_raw_trace_enable_get, asus_primeb550plus_hwmon_raw_trace_enable_set, "%llu\n");
+
+/* Debugfs files whose whole content is built at open */
+struct asus_primeb550plus_hwmon_dump_file {
+	size_t len;
+	unsigned char buf[];
+};
+
+/* Copies the ring at open, so a read gives one consistent trace */
+static int asus_primeb550plus_hwmon_raw_trace_open(struct inode *inode, struct file *file)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = inode->i_private;
+	struct asus_primeb550plus_hwmon_raw_trace_header header = {
+		.magic = ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_MAGIC,
+		.version = ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_VERSION,
+		.record_size = sizeof(struct asus_primeb550plus_hwmon_raw_record),
+	};
+	struct asus_primeb550plus_hwmon_dump_file *trace_file;
+	struct asus_primeb550plus_hwmon_raw_record *records;
+	unsigned int i, first;
+
+	trace_file = kvmalloc(struct_size(trace_file, buf, sizeof(header) + ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS * sizeof(*records)), GFP_KERNEL);
+	if (!trace_file)
+		return -ENOMEM;
+	records = (void *)(trace_file->buf + sizeof(header));
+
+	mutex_lock(&devdri_data->update_lock);
+	if (devdri_data->raw_trace.records) {
+		header.start_ns = devdri_data->raw_trace.start_ns;
+		header.nr_records = min_t(unsigned int, devdri_data->raw_trace.head, ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS);
+		first = devdri_data->raw_trace.head - header.nr_records;
+		for (i=0 ; i<header.nr_records ; i++)
+			records[i] = devdri_data->raw_trace.records[(first + i) % ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS];
+	}
+	mutex_unlock(&devdri_data->update_lock);
+
+	memcpy(trace_file->buf, &header, sizeof(header));
+	trace_file->len = sizeof(header) + header.nr_records * sizeof(*records);
+	file->private_data = trace_file;
+
+	return 0;
+}
+
+static ssize_t asus_primeb550plus_hwmon_dump_read(struct file *file, char __user *buf, size_t count, loff_t *ppos)
+{
+	struct asus_primeb550plus_hwmon_dump_file const * const trace_file = file->private_data;
+
+	return simple_read_from_buffer(buf, count, ppos, trace_file->buf, trace_file->len);
+}
+
+static int asus_primeb550plus_hwmon_dump_release(struct inode *inode, struct file *file)
+{
+	kvfree(file->private_data);
+
+	return 0;
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_raw_trace_fops = {
+	.owner = THIS_MODULE,
+	.open = asus_primeb550plus_hwmon_raw_trace_open,
+	.read = asus_primeb550plus_hwmon_dump_read,
+	.llseek = default_llseek,
+	.release = asus_primeb550plus_hwmon_dump_release,
+};
+
+/* Copies the archive at open, oldest block first */
+static int asus_primeb550plus_hwmon_archive_open(struct inode *inode, struct file *file)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = inode->i_private;
+	struct asus_primeb550plus_hwmon_archive_block const *blocks = devdri_data->archive.blocks;
+	struct asus_primeb550plus_hwmon_dump_file *archive_file;
+	unsigned int const nr_blocks = devdri_data->archive.nr_blocks;
+	unsigned int i, nr, first;
+
+	archive_file = kvmalloc(struct_size(archive_file, buf, nr_blocks * sizeof(*blocks)), GFP_KERNEL);
+	if (!archive_file)
+		return -ENOMEM;
+
+	mutex_lock(&devdri_data->update_lock);
+	nr = min(devdri_data->archive.head, nr_blocks);
+	first = devdri_data->archive.head - nr;
+	for (i=0 ; i<nr ; i++)
+		memcpy(archive_file->buf + i * sizeof(*blocks), &blocks[(first + i) % nr_blocks], sizeof(*blocks));
+	mutex_unlock(&devdri_data->update_lock);
+
+	archive_file->len = nr * sizeof(*blocks);
+	file->private_data = archive_file;
+
+	return 0;
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_archive_fops = {
+	.owner = THIS_MODULE,
+	.open = asus_primeb550plus_hwmon_archive_open,
+	.read = asus_primeb550plus_hwmon_dump_read,
+	.llseek = default_llseek,
+	.release = asus_primeb550plus_hwmon_dump_release,
+};
+
+/* Label values escape backslash, double quote and line feed */
+static void asus_primeb550plus_hwmon_metrics_escape(struct seq_buf *s, const char *str)
+{
+	for ( ; *str ; str++) {
+		switch (*str) {
+			case '\\':
+				seq_buf_puts(s, "\\\\");
+				break;
+			case '"':
+				seq_buf_puts(s, "\\\"");
+				break;
+			case '\n':
+				seq_buf_puts(s, "\\n");
+				break;
+			default:
+				seq_buf_putc(s, *str);
+		}
+	}
+}
+
+/* Prints a value in thousandths as a decimal number of units */
+static void asus_primeb550plus_hwmon_metrics_milli(struct seq_buf *s, long long val)
+{
+	unsigned long long const abs_val = val < 0 ? -(unsigned long long)val : val;
+
+	seq_buf_printf(s, "%s%llu.%03llu", val < 0 ? "-" : "", abs_val / 1000, abs_val % 1000);
+}
+
+/*
+ * OpenMetrics text of every connected channel, all from the same
+ * snapshot. Channels whose last read failed have no sample.
+ */
+static int asus_primeb550plus_hwmon_metrics_render(struct asus_primeb550plus_hwmon_data *devdri_data, struct asus_primeb550plus_hwmon_dump_file *metrics_file)
+{
+	struct asus_primeb550plus_hwmon_snapshot const *snapshot;
+	struct seq_buf s;
+	size_t i, j;
+
+	seq_buf_init(&s, (char *)metrics_file->buf, ASUS_B550PLUS_HWMON_METRICS_SIZE);
+
+	rcu_read_lock();
+	snapshot = rcu_dereference(devdri_data->snapshot);
+
+	for (i=0 ; i<ARRAY_SIZE(asus_primeb550plus_hwmon_type_descs) ; i++) {
+		const struct asus_primeb550plus_hwmon_type_desc *desc = &asus_primeb550plus_hwmon_type_descs[i];
+
+		seq_buf_printf(&s, "# TYPE %s gauge\n# UNIT %s %s\n# HELP %s %s.\n", desc->metric, desc->metric, desc->unit, desc->metric, desc->help);
+		for (j=0 ; j<desc->nr_fields ; j++) {
+			enum asus_primeb550plus_hwmon_field_list const field_index = desc->fields[j];
+
+			if (!(READ_ONCE(devdri_data->present) & BIT_ULL(field_index)) || snapshot->fields[field_index].error)
+				continue;
+
+			seq_buf_printf(&s, "%s{sensor=\"%s%zu\",label=\"", desc->metric, desc->name, desc->index_base + j);
+			asus_primeb550plus_hwmon_metrics_escape(&s, asus_primeb550plus_hwmon_chip_fields[field_index]->label);
+			seq_buf_puts(&s, "\"} ");
+			if (desc->milli)
+				asus_primeb550plus_hwmon_metrics_milli(&s, snapshot->fields[field_index].value);
+			else
+				seq_buf_printf(&s, "%ld", snapshot->fields[field_index].value);
+			seq_buf_putc(&s, '\n');
+		}
+	}
+
+	seq_buf_puts(&s, "# TYPE asus_primeb550plus_hwmon_sweep_age_seconds gauge\n# UNIT asus_primeb550plus_hwmon_sweep_age_seconds seconds\n# HELP asus_primeb550plus_hwmon_sweep_age_seconds Time since the sweep the values come from.\nasus_primeb550plus_hwmon_sweep_age_seconds ");
+	asus_primeb550plus_hwmon_metrics_milli(&s, div_u64(ktime_get_ns() - snapshot->timestamp_ns, NSEC_PER_MSEC));
+	seq_buf_puts(&s, "\n# EOF\n");
+
+	rcu_read_unlock();
+
+	this_cpu_inc(*devdri_data->cache_hits);
+
+	if (seq_buf_has_overflowed(&s))
+		return -EOVERFLOW;
+
+	metrics_file->len = seq_buf_used(&s);
+	return 0;
+}
+
+/* Rendered at open, so every reader gets a whole scrape of its own */
+static int asus_primeb550plus_hwmon_metrics_open(struct inode *inode, struct file *file)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = inode->i_private;
+	struct asus_primeb550plus_hwmon_dump_file *metrics_file;
+	int err;
+
+	metrics_file = kvmalloc(struct_size(metrics_file, buf, ASUS_B550PLUS_HWMON_METRICS_SIZE), GFP_KERNEL);
+	if (!metrics_file)
+		return -ENOMEM;
+
+	asus_primeb550plus_hwmon_consume(devdri_data);
+	if ((err = asus_primeb550plus_hwmon_metrics_render(devdri_data, metrics_file))) {
+		kvfree(metrics_file);
+		return err;
+	}
+	file->private_data = metrics_file;
+
+	return 0;
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_metrics_fops = {
+	.owner = THIS_MODULE,
+	.open = asus_primeb550plus_hwmon_metrics_open,
+	.read = asus_primeb550plus_hwmon_dump_read,
+	.llseek = default_llseek,
+	.release = asus_primeb550plus_hwmon_dump_release,
+};
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+/*
+ * A trace (as read from raw_trace) is loaded once completely written,
+ * starting at offset 0 replaces it. Records must be in recording order.
+ */
+static ssize_t asus_primeb550plus_hwmon_replay_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = file->private_data;
+	struct asus_primeb550plus_hwmon_emulated * const emulated = devdri_data->emulated;
+	struct asus_primeb550plus_hwmon_raw_record const * const records = (void *)(emulated->replay_buf + sizeof(struct asus_primeb550plus_hwmon_raw_trace_header));
+	struct asus_primeb550plus_hwmon_raw_trace_header header;
+	unsigned int i;
+	ssize_t ret;
+
+	mutex_lock(&devdri_data->update_lock);
+
+	if (!*ppos) {
+		emulated->replay_len = 0;
+		emulated->nr_replay = 0;
+		emulated->replay_cursor = 0;
+	}
+
+	if ((ret = simple_write_to_buffer(emulated->replay_buf, sizeof(emulated->replay_buf), ppos, buf, count)) < 0)
+		goto out;
+	emulated->replay_len = max_t(size_t, emulated->replay_len, *ppos);
+
+	if (emulated->replay_len < sizeof(header))
+		goto out;
+	memcpy(&header, emulated->replay_buf, sizeof(header));
+	if (header.magic != ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_MAGIC || header.version != ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_VERSION ||
+	    header.record_size != sizeof(struct asus_primeb550plus_hwmon_raw_record) || header.nr_records > ASUS_B550PLUS_HWMON_RAW_TRACE_RECORDS) {
+		ret = -EINVAL;
+		goto out;
+	}
+	if (emulated->replay_len == sizeof(header) + header.nr_records * sizeof(struct asus_primeb550plus_hwmon_raw_record)) {
+		for (i=1 ; i<header.nr_records ; i++) {
+			if (records[i].time_ns < records[i-1].time_ns) {
+				ret = -EINVAL;
+				goto out;
+			}
+		}
+		emulated->nr_replay = header.nr_records;
+		asus_primeb550plus_hwmon_presence_recheck(devdri_data);
+	}
+
+out:
+	mutex_unlock(&devdri_data->update_lock);
+	return ret;
+}
+
+static const struct file_operations asus_primeb550plus_hwmon_replay_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.write = asus_primeb550plus_hwmon_replay_write,
+	.llseek = default_llseek,
+};
+#endif
+
+static void asus_primeb550plus_hwmon_debugfs_remove(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	debugfs_remove_recursive(devdri_data->debugfs_dir);
+}
+
+static int asus_primeb550plus_hwmon_debugfs_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct dentry *backend_dir, *sampler_dir, *watchdog_dir;
+	char name[64];
+
+	snprintf(name, sizeof(name), "asus_primeb550plus_hwmon-%s", dev_name(dev));
+	devdri_data->debugfs_dir = debugfs_create_dir(name, NULL);
+
+	debugfs_create_file("cache_hits", 0444, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_cache_hits_fops);
+	debugfs_create_u64("cache_misses", 0444, devdri_data->debugfs_dir, &devdri_data->cache_misses);
+	debugfs_create_u64("paired_read_retries", 0444, devdri_data->debugfs_dir, &devdri_data->paired_read_retries);
+	debugfs_create_u64("paired_read_failures", 0444, devdri_data->debugfs_dir, &devdri_data->paired_read_failures);
+	debugfs_create_u64("plan_verify_mismatches", 0444, devdri_data->debugfs_dir, &devdri_data->plan_verify_mismatches);
+
+	backend_dir = debugfs_create_dir("backend", devdri_data->debugfs_dir);
+	debugfs_create_file("calls", 0444, backend_dir, devdri_data, &asus_primeb550plus_hwmon_backend_calls_fops);
+	debugfs_create_file("errors", 0444, backend_dir, devdri_data, &asus_primeb550plus_hwmon_backend_errors_fops);
+	debugfs_create_file("latency", 0444, backend_dir, devdri_data, &asus_primeb550plus_hwmon_latency_fops);
+	debugfs_create_file("breakers", 0444, backend_dir, devdri_data, &asus_primeb550plus_hwmon_breakers_fops);
+	debugfs_create_file("raw_trace_enable", 0600, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_raw_trace_enable_fops);
+	debugfs_create_file("raw_trace", 0400, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_raw_trace_fops);
+	if (devdri_data->archive.nr_blocks)
+		debugfs_create_file("archive", 0400, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_archive_fops);
+	debugfs_create_file("metrics", 0444, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_metrics_fops);
+	debugfs_create_file("intervals", 0444, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_intervals_fops);
+	debugfs_create_file("bench", 0400, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_bench_fops);
+	sampler_dir = debugfs_create_dir("sampler", devdri_data->debugfs_dir);
+	debugfs_create_u64("wakeups", 0444, sampler_dir, &devdri_data->sampler_wakeups);
+	debugfs_create_u64("achieved_interval_us", 0444, sampler_dir, &devdri_data->sampler_achieved_us);
+	debugfs_create_ulong("period", 0444, sampler_dir, &devdri_data->sampler_period);
+	debugfs_create_u64("catch_ups", 0444, sampler_dir, &devdri_data->catch_ups);
+	watchdog_dir = debugfs_create_dir("watchdog", devdri_data->debugfs_dir);
+	debugfs_create_u64("trips", 0444, watchdog_dir, &devdri_data->watchdog_trips);
+	debugfs_create_u64("latency_ns", 0444, watchdog_dir, &devdri_data->watchdog_latency_ns);
+	debugfs_create_u64("latency_max_ns", 0444, watchdog_dir, &devdri_data->watchdog_latency_max_ns);
+	debugfs_create_u64("debounce_ns", 0444, watchdog_dir, &devdri_data->watchdog_debounce_ns);
+	debugfs_create_u64("chip_writes", 0444, devdri_data->debugfs_dir, &devdri_data->chip_writes);
+	debugfs_create_u64("chip_write_errors", 0444, devdri_data->debugfs_dir, &devdri_data->chip_write_errors);
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+	if (devdri_data->emulated) {
+		debugfs_create_file("registers", 0600, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_registers_fops);
+		debugfs_create_file("replay", 0200, devdri_data->debugfs_dir, devdri_data, &asus_primeb550plus_hwmon_replay_fops);
+	}
+#endif
+
+	return devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_debugfs_remove, devdri_data);
+}
+
+/* hwmon device, then IIO and PMU, showing the channels present so far */
+static int asus_primeb550plus_hwmon_frontends_init(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	struct device *hwmon_dev;
+	int err;
+
+	if ((err = asus_primeb550plus_hwmon_extra_attrs_init(dev, devdri_data)))
+		return err;
+
+	/* Unregistered by hwmon_remove, in the place probe gave it */
+	hwmon_dev = hwmon_device_register_with_info(dev, "asus_primeb550plus_hwmon", devdri_data, &asus_primeb550plus_hwmon_chip_info, devdri_data->extra_groups);
+	if ((err = PTR_ERR_OR_ZERO(hwmon_dev)))
+		return err;
+	mutex_lock(&devdri_data->update_lock);
+	devdri_data->device = hwmon_dev;
+	mutex_unlock(&devdri_data->update_lock);
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_IIO
+	if ((err = asus_primeb550plus_hwmon_iio_init(dev, devdri_data)))
+		return err;
+#endif
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+	err = asus_primeb550plus_hwmon_pmu_init(dev, devdri_data);
+#endif
+
+	return err;
+}
+
+/*
+ * A channel is connected when it moved, or did not stay at 0 or at an
+ * end of its range. A fan stopped on purpose needs force_present.
+ */
+static bool asus_primeb550plus_hwmon_presence_connected(struct asus_primeb550plus_hwmon_data *devdri_data, size_t field_index)
+{
+	long const first = devdri_data->presence.first[field_index];
+	long lowest, highest;
+
+	if (!(devdri_data->presence.readable & BIT_ULL(field_index)))
+		return false;
+	if (devdri_data->presence.varying & BIT_ULL(field_index))
+		return true;
+
+	asus_primeb550plus_hwmon_field_range(asus_primeb550plus_hwmon_chip_fields[field_index], &lowest, &highest);
+	return first && first != lowest && first != highest;
+}
+
+/*
+ * Detection pass over the channels not present yet: they are read
+ * ASUS_B550PLUS_HWMON_PRESENCE_SAMPLES times, then those found connected
+ * join the sweeps. The first pass runs right after probe and registers
+ * the frontends with what it found, later ones every presence_recheck
+ * seconds while some are missing.
+ */
+static void asus_primeb550plus_hwmon_presence_work(struct work_struct *work)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = container_of(to_delayed_work(work), struct asus_primeb550plus_hwmon_data, presence_work);
+	long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	u64 candidates, found = 0;
+	unsigned int recheck;
+	size_t i;
+	int err;
+
+	mutex_lock(&devdri_data->update_lock);
+
+	candidates = asus_primeb550plus_hwmon_possible_fields() & ~devdri_data->present;
+	if (!candidates)
+		goto out;
+
+	asus_primeb550plus_hwmon_plan_read(devdri_data, candidates, values, errors);
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		if (!(candidates & BIT_ULL(i)) || errors[i])
+			continue;
+		if (!(devdri_data->presence.readable & BIT_ULL(i))) {
+			devdri_data->presence.readable |= BIT_ULL(i);
+			devdri_data->presence.first[i] = values[i];
+		} else if (values[i] != devdri_data->presence.first[i]) {
+			devdri_data->presence.varying |= BIT_ULL(i);
+		}
+	}
+
+	if (++devdri_data->presence.samples < ASUS_B550PLUS_HWMON_PRESENCE_SAMPLES) {
+		mutex_unlock(&devdri_data->update_lock);
+		queue_delayed_work(system_power_efficient_wq, &devdri_data->presence_work, msecs_to_jiffies(ASUS_B550PLUS_HWMON_PRESENCE_DELAY));
+		return;
+	}
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		if (!(candidates & BIT_ULL(i)))
+			continue;
+		if (asus_primeb550plus_hwmon_presence_connected(devdri_data, i)) {
+			found |= BIT_ULL(i);
+			/* Read on the next sweep, whatever its schedule said */
+			devdri_data->schedule[i].next_due = jiffies;
+		} else {
+			dev_dbg(devdri_data->parent, "%s looks unconnected\n", asus_primeb550plus_hwmon_chip_fields[i]->label);
+		}
+	}
+	WRITE_ONCE(devdri_data->present, devdri_data->present | found);
+	devdri_data->presence.samples = 0;
+	devdri_data->presence.readable = 0;
+	devdri_data->presence.varying = 0;
+
+out:
+	mutex_unlock(&devdri_data->update_lock);
+
+	if (found) {
+		dev_info(devdri_data->parent, "%d of %d channels connected\n", hweight64(READ_ONCE(devdri_data->present)), ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+		mod_delayed_work(asus_primeb550plus_hwmon_sampler_wq(), asus_primeb550plus_hwmon_sampler_dwork(devdri_data), 0);
+	}
+
+	/* Channels found later are swept, but only show up in sysfs, IIO and perf once rebound */
+	if (!devdri_data->registered) {
+		devdri_data->registered = true;
+		if ((err = asus_primeb550plus_hwmon_frontends_init(devdri_data->parent, devdri_data)))
+			dev_err(devdri_data->parent, "Frontend registration failed: %d\n", err);
+	}
+
+	recheck = READ_ONCE(presence_recheck);
+	if (recheck && candidates != found)
+		queue_delayed_work(system_power_efficient_wq, &devdri_data->presence_work, secs_to_jiffies(recheck));
+}
+
+static void asus_primeb550plus_hwmon_presence_stop(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+
+	disable_delayed_work_sync(&devdri_data->presence_work);
+}
+
+static void asus_primeb550plus_hwmon_hwmon_remove(void *data)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = data;
+	struct device *hwmon_dev = devdri_data->device;
+
+	if (!hwmon_dev)
+		return;
+	mutex_lock(&devdri_data->update_lock);
+	devdri_data->device = NULL;
+	mutex_unlock(&devdri_data->update_lock);
+	hwmon_device_unregister(hwmon_dev);
+}
+
+/* Everything but finding the chip, devdri_data->backend must be set */
+static int asus_primeb550plus_hwmon_probe(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	int err;
+
+	mutex_init(&devdri_data->update_lock);
+	devdri_data->update_interval = ASUS_B550PLUS_HWMON_UPDATE_INTERVAL_DEFAULT;
+	asus_primeb550plus_hwmon_limits_init(devdri_data);
+	asus_primeb550plus_hwmon_fan_curves_init(devdri_data);
+	asus_primeb550plus_hwmon_plan_init(devdri_data);
+	devdri_data->sampler_period = devdri_data->update_interval;
+	devdri_data->last_consumed = jiffies;
+	/* A deferrable timer does not wake an idle CPU, readers catch up instead */
+	if (low_wakeup)
+		INIT_DEFERRABLE_WORK(&devdri_data->sampler_work, asus_primeb550plus_hwmon_sampler_work);
+	else
+		INIT_DELAYED_WORK(&devdri_data->sampler_work, asus_primeb550plus_hwmon_sampler_work);
+	INIT_DELAYED_WORK(&devdri_data->sampler_timely_work, asus_primeb550plus_hwmon_sampler_timely_work);
+	INIT_DEFERRABLE_WORK(&devdri_data->presence_work, asus_primeb550plus_hwmon_presence_work);
+
+	devdri_data->backend_stats = devm_alloc_percpu(dev, struct asus_primeb550plus_hwmon_backend_stats);
+	if (!devdri_data->backend_stats) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	if ((err = asus_primeb550plus_hwmon_check_chip(dev, devdri_data)))
+		goto out;
+
+	asus_primeb550plus_hwmon_presence_init(devdri_data);
+
+	if ((err = asus_primeb550plus_hwmon_archive_init(dev, devdri_data)))
+		goto out;
+
+	/* Recorded into by every read, until the sampler and readers are gone */
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_raw_trace_free, devdri_data)))
+		goto out;
+
+	devdri_data->cache_hits = devm_alloc_percpu(dev, u64);
+	if (!devdri_data->cache_hits) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_snapshot_free, devdri_data)))
+		goto out;
+
+	/* Readers expect a snapshot to always be there */
+	asus_primeb550plus_hwmon_refresh(devdri_data, 0);
+	if (!rcu_access_pointer(devdri_data->snapshot)) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	devdri_data->parent = dev;
+	dev_set_drvdata(dev, devdri_data);
+
+	/* After the sampler and the hwmon device are gone */
+	if (devdri_data->writable && (err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_fan_curves_stop, devdri_data)))
+		goto out;
+
+	/* The hwmon device comes with the first detection pass, it goes after the sampler */
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_hwmon_remove, devdri_data)))
+		goto out;
+
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_sampler_stop, devdri_data)))
+		goto out;
+	queue_delayed_work(asus_primeb550plus_hwmon_sampler_wq(), &devdri_data->sampler_work, 0);
+
+	if ((err = asus_primeb550plus_hwmon_debugfs_init(dev, devdri_data)))
+		goto out;
+
+	if ((err = asus_primeb550plus_hwmon_miscdev_init(dev, devdri_data)))
+		goto out;
+
+	/* Detection reads the chip on its own, not holding the probe, and registers the frontends */
+	if ((err = devm_add_action_or_reset(dev, asus_primeb550plus_hwmon_presence_stop, devdri_data)))
+		goto out;
+	queue_delayed_work(system_power_efficient_wq, &devdri_data->presence_work, 0);
+
+out:
+	return err;
+}
+
+static int asus_primeb550plus_hwmon_add(struct acpi_device *device)
+{
+	int err;
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+
+	if ((err = asus_primeb550plus_hwmon_check_dmi())) {
+		dev_info(&device->dev, "Unsupported system DMI\n");
+		goto out;
+	}
+
+	if (strcmp("ASUSWMI", acpi_device_uid(device))) {
+		err = -ENODEV;
+		dev_info(&device->dev, "Unsupported device uid\n");
+		goto out;
+	}
+
+	devdri_data = devm_kzalloc(&device->dev, sizeof(*devdri_data), GFP_KERNEL);
+	if (!devdri_data) {
+		err =  -ENOMEM;
+		goto out;
+	}
+
+	devdri_data->acpi_dev = device;
+	devdri_data->acpi_dev_handle = device->handle;
+
+	if ((err = asus_primeb550plus_hwmon_get_method_handles(devdri_data)))
+		goto out;
+
+	if (!strcmp(backend, "superio")) {
+		if ((err = asus_primeb550plus_hwmon_superio_init(&device->dev, devdri_data, &asus_primeb550plus_hwmon_real_ports, NULL)))
+			goto out;
+	} else if (!strcmp(backend, "rhwm")) {
+		devdri_data->backend = &asus_primeb550plus_hwmon_rhwm_backend;
+	} else {
+		dev_err(&device->dev, "Unknown backend %s\n", backend);
+		err = -EINVAL;
+		goto out;
+	}
+
+	if (allow_writes && !devdri_data->backend->write_u8)
+		dev_warn(&device->dev, "Backend %s cannot write, fan control disabled\n", devdri_data->backend->name);
+	devdri_data->writable = allow_writes && devdri_data->backend->write_u8;
+
+	err = asus_primeb550plus_hwmon_probe(&device->dev, devdri_data);
+
+out:
+	return err;
+}
+
+/* Before devm teardown, the presence work may still be adding to it */
+static void asus_primeb550plus_hwmon_remove(struct acpi_device *device)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = dev_get_drvdata(&device->dev);
+
+	disable_delayed_work_sync(&devdri_data->presence_work);
+}
+
+static struct acpi_driver asus_primeb550plus_hwmon_driver = {
+	.name = "asus-primeb550plus-hwmon",
+	.class = "hwmon",
+	.ids = asus_primeb550plus_hwmon_acpi_ids,
+	.ops = {
+		.add = asus_primeb550plus_hwmon_add,
+		.remove = asus_primeb550plus_hwmon_remove,
+	},
+	/* Probe reads the chip (identification, first sweep), don't hold the boot */
+	.drv.probe_type = PROBE_PREFER_ASYNCHRONOUS,
+};
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+static int asus_primeb550plus_hwmon_emulated_probe(struct platform_device *pdev)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+	struct asus_primeb550plus_hwmon_emulated *emulated;
+	int err;
+
+	devdri_data = devm_kzalloc(&pdev->dev, sizeof(*devdri_data), GFP_KERNEL);
+	emulated = devm_kzalloc(&pdev->dev, sizeof(*emulated), GFP_KERNEL);
+	if (!devdri_data || !emulated)
+		return -ENOMEM;
+
+	/* Pass check_chip, every other register reads 0 until set */
+	emulated->regs[ASUS_B550PLUS_HWMON_VENDOR_ID_BANK][ASUS_B550PLUS_HWMON_VENDOR_ID_INDEX] = asus_primeb550plus_hwmon_supported_superios[0].vendor_id_high;
+	emulated->regs[ASUS_B550PLUS_HWMON_CHIP_ID_BANK][ASUS_B550PLUS_HWMON_CHIP_ID_INDEX] = asus_primeb550plus_hwmon_supported_superios[0].chip_id;
+
+	devdri_data->emulated = emulated;
+	if (!strcmp(backend, "superio")) {
+		if ((err = asus_primeb550plus_hwmon_superio_init(&pdev->dev, devdri_data, &asus_primeb550plus_hwmon_emulated_ports, emulated)))
+			return err;
+	} else if (!strcmp(backend, "replay")) {
+		devdri_data->backend = &asus_primeb550plus_hwmon_replay_backend;
+		devdri_data->backend_data = emulated;
+	} else {
+		devdri_data->backend = &asus_primeb550plus_hwmon_emulated_backend;
+		devdri_data->backend_data = emulated;
+	}
+	/* Nothing to break here */
+	devdri_data->writable = devdri_data->backend->write_u8;
+
+	return asus_primeb550plus_hwmon_probe(&pdev->dev, devdri_data);
+}
+
+#if IS_ENABLED(CONFIG_ASUS_PRIMEB550PLUS_HWMON_KUNIT_TEST)
+/* Emulated register file of asus_primeb550plus_hwmon_kunit, see asus_primeb550plus_hwmon_kunit.h */
+struct asus_primeb550plus_hwmon_kunit_regs {
+	struct asus_primeb550plus_hwmon_emulated emulated;	/* first, read by emulated_read_u8 */
+	unsigned char glitch_bank;
+	unsigned char glitch_index;
+	unsigned int glitches;
+	bool fail;
+	unsigned char fail_bank;
+	unsigned char fail_index;
+};
+
+static int asus_primeb550plus_hwmon_kunit_read_u8(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char *dest)
+{
+	struct asus_primeb550plus_hwmon_kunit_regs * const regs = devdri_data->backend_data;
+	int err;
+
+	if (regs->fail && bank == regs->fail_bank && index == regs->fail_index)
+		return -EIO;
+	if ((err = asus_primeb550plus_hwmon_emulated_read_u8(devdri_data, bank, index, dest)))
+		return err;
+
+	if (regs->glitches && bank == regs->glitch_bank && index == regs->glitch_index) {
+		regs->glitches--;
+		regs->emulated.regs[bank][index]++;
+	}
+	return 0;
+}
+
+static const struct asus_primeb550plus_hwmon_backend_ops asus_primeb550plus_hwmon_kunit_backend = {
+	.name = "kunit",
+	.read_u8 = asus_primeb550plus_hwmon_kunit_read_u8,
+};
+
+struct asus_primeb550plus_hwmon_data *asus_primeb550plus_hwmon_kunit_alloc(void)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data;
+	struct asus_primeb550plus_hwmon_kunit_regs *regs;
+
+	devdri_data = kzalloc(sizeof(*devdri_data), GFP_KERNEL);
+	regs = kzalloc(sizeof(*regs), GFP_KERNEL);
+	if (!devdri_data || !regs)
+		goto err;
+	if (!(devdri_data->backend_stats = alloc_percpu(struct asus_primeb550plus_hwmon_backend_stats)))
+		goto err;
+
+	mutex_init(&devdri_data->update_lock);
+	devdri_data->backend = &asus_primeb550plus_hwmon_kunit_backend;
+	devdri_data->backend_data = regs;
+	asus_primeb550plus_hwmon_plan_init(devdri_data);
+	return devdri_data;
+
+err:
+	kfree(regs);
+	kfree(devdri_data);
+	return NULL;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_alloc);
+
+void asus_primeb550plus_hwmon_kunit_free(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	free_percpu(devdri_data->backend_stats);
+	kfree(devdri_data->backend_data);
+	kfree(devdri_data);
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_free);
+
+void asus_primeb550plus_hwmon_kunit_set_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value)
+{
+	struct asus_primeb550plus_hwmon_kunit_regs * const regs = devdri_data->backend_data;
+
+	if (bank < ASUS_B550PLUS_HWMON_EMULATED_BANKS)
+		regs->emulated.regs[bank][index] = value;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_set_reg);
+
+void asus_primeb550plus_hwmon_kunit_glitch_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned int count)
+{
+	struct asus_primeb550plus_hwmon_kunit_regs * const regs = devdri_data->backend_data;
+
+	regs->glitch_bank = bank;
+	regs->glitch_index = index;
+	regs->glitches = count;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_glitch_reg);
+
+void asus_primeb550plus_hwmon_kunit_fail_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index)
+{
+	struct asus_primeb550plus_hwmon_kunit_regs * const regs = devdri_data->backend_data;
+
+	regs->fail = true;
+	regs->fail_bank = bank;
+	regs->fail_index = index;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_fail_reg);
+
+static int asus_primeb550plus_hwmon_kunit_field(const char *label)
+{
+	int i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++)
+		if (!strcmp(asus_primeb550plus_hwmon_chip_fields[i]->label, label))
+			return i;
+
+	return -ENOENT;
+}
+
+int asus_primeb550plus_hwmon_kunit_read_field(struct asus_primeb550plus_hwmon_data *devdri_data, const char *label, long *val)
+{
+	int i, err;
+
+	if ((i = asus_primeb550plus_hwmon_kunit_field(label)) < 0)
+		return i;
+
+	mutex_lock(&devdri_data->update_lock);
+	err = asus_primeb550plus_hwmon_read_field(devdri_data, asus_primeb550plus_hwmon_chip_fields[i], val);
+	mutex_unlock(&devdri_data->update_lock);
+	return err;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_read_field);
+
+int asus_primeb550plus_hwmon_kunit_plan_read(struct asus_primeb550plus_hwmon_data *devdri_data, const char *label, long *val)
+{
+	long values[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int errors[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX];
+	int i;
+
+	if ((i = asus_primeb550plus_hwmon_kunit_field(label)) < 0)
+		return i;
+
+	mutex_lock(&devdri_data->update_lock);
+	asus_primeb550plus_hwmon_plan_read(devdri_data, BIT_ULL(i), values, errors);
+	mutex_unlock(&devdri_data->update_lock);
+
+	if (!errors[i])
+		*val = values[i];
+	return errors[i];
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_plan_read);
+
+void asus_primeb550plus_hwmon_kunit_paired_reads(struct asus_primeb550plus_hwmon_data *devdri_data, u64 *retries, u64 *failures)
+{
+	*retries = devdri_data->paired_read_retries;
+	*failures = devdri_data->paired_read_failures;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_paired_reads);
+
+u64 asus_primeb550plus_hwmon_kunit_verify_mismatches(struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	return devdri_data->plan_verify_mismatches;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_verify_mismatches);
+
+void asus_primeb550plus_hwmon_kunit_open_breaker(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank)
+{
+	struct asus_primeb550plus_hwmon_breaker *breaker;
+
+	if (bank >= ASUS_B550PLUS_HWMON_BREAKER_BANKS)
+		return;
+
+	breaker = &devdri_data->breakers[bank];
+	breaker->backoff = ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MAX;
+	breaker->retry_at = jiffies + msecs_to_jiffies(ASUS_B550PLUS_HWMON_BREAKER_BACKOFF_MAX);
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_open_breaker);
+
+int asus_primeb550plus_hwmon_kunit_check_chip(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data)
+{
+	int err;
+
+	mutex_lock(&devdri_data->update_lock);
+	err = asus_primeb550plus_hwmon_check_chip(dev, devdri_data);
+	mutex_unlock(&devdri_data->update_lock);
+	return err;
+}
+EXPORT_SYMBOL_IF_KUNIT(asus_primeb550plus_hwmon_kunit_check_chip);
+#endif
+
+static void asus_primeb550plus_hwmon_emulated_remove(struct platform_device *pdev)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = platform_get_drvdata(pdev);
+
+	disable_delayed_work_sync(&devdri_data->presence_work);
+}
+
+static struct platform_driver asus_primeb550plus_hwmon_emulated_driver = {
+	.driver = {
+		.name = "asus-primeb550plus-hwmon-emulated",
+	},
+	.remove = asus_primeb550plus_hwmon_emulated_remove,
+};
+
+static struct platform_device *asus_primeb550plus_hwmon_emulated_device;
+#endif
+
+static int __init asus_primeb550plus_hwmon_init(void)
+{
+	int err;
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+	if ((err = asus_primeb550plus_hwmon_pmu_hp_init()))
+		return err;
+#endif
+
+	if ((err = acpi_bus_register_driver(&asus_primeb550plus_hwmon_driver)))
+		goto out_pmu;
+
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+	asus_primeb550plus_hwmon_emulated_device = platform_create_bundle(&asus_primeb550plus_hwmon_emulated_driver, asus_primeb550plus_hwmon_emulated_probe, NULL, 0, NULL, 0);
+	if (IS_ERR(asus_primeb550plus_hwmon_emulated_device)) {
+		err = PTR_ERR(asus_primeb550plus_hwmon_emulated_device);
+		acpi_bus_unregister_driver(&asus_primeb550plus_hwmon_driver);
+		goto out_pmu;
+	}
+#endif
+
+	return 0;
+
+out_pmu:
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+	asus_primeb550plus_hwmon_pmu_hp_exit();
+#endif
+	return err;
+}
+
+static void __exit asus_primeb550plus_hwmon_exit(void)
+{
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_EMULATED
+	platform_device_unregister(asus_primeb550plus_hwmon_emulated_device);
+	platform_driver_unregister(&asus_primeb550plus_hwmon_emulated_driver);
+#endif
+	acpi_bus_unregister_driver(&asus_primeb550plus_hwmon_driver);
+#ifdef CONFIG_ASUS_PRIMEB550PLUS_HWMON_PERF
+	asus_primeb550plus_hwmon_pmu_hp_exit();
+#endif
+}
+
+module_init(asus_primeb550plus_hwmon_init);
+module_exit(asus_primeb550plus_hwmon_exit);
 MODULE_LICENSE("GPL");
 
 
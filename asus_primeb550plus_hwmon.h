@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Userspace interface of asus_primeb550plus_hwmon.
+ */
+
+#ifndef ASUS_PRIMEB550PLUS_HWMON_H
+#define ASUS_PRIMEB550PLUS_HWMON_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+/*
+ * Number of channels, in driver field order: in0-in15, temp1-temp19,
+ * fan1-fan7 (same order as their hwmon numbering).
+ */
+#define ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS	42
+
+/*
+ * Record read from /dev/asus_hwmonN, one per sample. Values are in hwmon
+ * units (mV, m°C, RPM). Bit n of valid is set when channel n could be
+ * read; values of other channels are meaningless. sequence is
+ * incremented for every sample taken, so a gap means records were
+ * dropped because the reader was too slow.
+ */
+struct asus_primeb550plus_hwmon_sample {
+	__u64 timestamp_ns;	/* CLOCK_MONOTONIC, time of the sweep */
+	__u64 sequence;
+	__u64 valid;
+	__s32 values[ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS];
+};
+
+#define ASUS_PRIMEB550PLUS_HWMON_BULK_VERSION	1
+
+/*
+ * Content of the all_sensors binary attribute of the hwmon device: every
+ * channel of one sweep, in one read. Fields only get appended, version is
+ * bumped when they do. Units and valid as in
+ * struct asus_primeb550plus_hwmon_sample.
+ */
+struct asus_primeb550plus_hwmon_bulk {
+	__u32 version;
+	__u32 nr_channels;
+	__u64 timestamp_ns;	/* CLOCK_MONOTONIC, time of the sweep */
+	__u64 valid;
+	__s32 values[ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS];
+};
+
+/*
+ * Raw register trace, read from debugfs raw_trace while recording is (or
+ * was) enabled with raw_trace_enable: a header followed by nr_records
+ * records, oldest first. The same format can be written to the replay
+ * file of the emulated instance. Little endian, as the hardware.
+ */
+#define ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_MAGIC	0x54574841	/* "AHWT" */
+#define ASUS_PRIMEB550PLUS_HWMON_RAW_TRACE_VERSION	2
+
+struct asus_primeb550plus_hwmon_raw_trace_header {
+	__u32 magic;
+	__u32 version;
+	__u64 start_ns;		/* CLOCK_MONOTONIC, recording start */
+	__u32 nr_records;
+	__u32 record_size;	/* sizeof(struct asus_primeb550plus_hwmon_raw_record) */
+};
+
+#define ASUS_PRIMEB550PLUS_HWMON_RAW_RECORD_ERROR	0x01	/* read failed, value is 0 */
+
+struct asus_primeb550plus_hwmon_raw_record {
+	__u64 time_ns;		/* since start_ns */
+	__u8 bank;
+	__u8 index;
+	__u8 value;
+	__u8 flags;
+	__u32 reserved;
+};
+
+/*
+ * Compressed history of every sweep, read from debugfs archive: a
+ * sequence of fixed size blocks, oldest first. Samples are encoded
+ * against the previous one of the same block, so every block decodes on
+ * its own, starting from time = start_ns, valid = channels and every
+ * value at 0:
+ *
+ *	for each of the nr_samples samples in payload:
+ *		time += varint() * 1000000
+ *		valid ^= varint()
+ *		for each bit n of valid, lowest first:
+ *			values[n] += zigzag(varint())
+ *		sample is time, valid, values
+ *
+ * varint() is LEB128: 7 bits per byte, least significant first, high bit
+ * set on every byte but the last. zigzag(u) is (u >> 1) ^ -(u & 1).
+ * Channels not in valid keep their previous (meaningless) value. Units
+ * as in struct asus_primeb550plus_hwmon_sample, little endian.
+ * tools/archive_decode turns an archive into CSV.
+ */
+#define ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_MAGIC		0x48574841	/* "AHWH" */
+#define ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_VERSION	1
+#define ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_BLOCK_SIZE	4096
+
+struct asus_primeb550plus_hwmon_archive_block {
+	__u32 magic;
+	__u16 version;
+	__u16 used;		/* bytes of payload */
+	__u64 sequence;		/* blocks started before this one */
+	__u64 start_ns;		/* CLOCK_MONOTONIC */
+	__u64 channels;		/* bit n set: channel n is recorded */
+	__u32 nr_samples;
+	__u32 reserved;
+	__u8 payload[ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_BLOCK_SIZE - 40];
+};
+
+#define ASUS_PRIMEB550PLUS_HWMON_IOC_MAGIC	0xb5
+
+/*
+ * Sample period of the calling open file, in milliseconds. Periods below
+ * the hwmon update_interval need the file to be opened with
+ * CAP_SYS_ADMIN (EPERM otherwise).
+ */
+#define ASUS_PRIMEB550PLUS_HWMON_IOC_SET_PERIOD	_IOW(ASUS_PRIMEB550PLUS_HWMON_IOC_MAGIC, 0x01, __u32)
+#define ASUS_PRIMEB550PLUS_HWMON_IOC_GET_PERIOD	_IOR(ASUS_PRIMEB550PLUS_HWMON_IOC_MAGIC, 0x02, __u32)
+
+#endif
@@ -0,0 +1,367 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Field table of asus_primeb550plus_hwmon and decoding of raw register
+ * bytes into hwmon units. Plain C, no kernel header needed, so that it
+ * can be built outside of the kernel too (see tools/).
+ */
+
+#ifndef ASUS_PRIMEB550PLUS_HWMON_DECODE_H
+#define ASUS_PRIMEB550PLUS_HWMON_DECODE_H
+
+#define ASUS_B550PLUS_HWMON_U8_MAX	0xff
+#define ASUS_B550PLUS_HWMON_U16_MAX	0xffff
+
+enum asus_primeb550plus_hwmon_data_type {
+	ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL,
+	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT,
+	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT,
+	ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT,
+	ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16,
+};
+
+struct asus_primeb550plus_hwmon_data_type_uchar_mul {
+	unsigned char bank_no;
+	unsigned char index_in_bank;
+	int multiplier;
+};
+
+struct asus_primeb550plus_hwmon_data_type_temp_9bit {
+	unsigned char int_bank_no;
+	unsigned char int_index_in_bank;
+	unsigned char frac_bank_no;
+	unsigned char frac_index_in_bank;
+};
+
+struct asus_primeb550plus_hwmon_data_type_temp_8bit {
+	unsigned char bank_no;
+	unsigned char index_in_bank;
+};
+
+struct asus_primeb550plus_hwmon_data_type_temp_14bit {
+	unsigned char int_bank_no;
+	unsigned char int_idx;
+	unsigned char frac_bank_no;
+	unsigned char frac_idx;
+};
+
+struct asus_primeb550plus_hwmon_data_type_pwm16 {
+	unsigned char high_bank_no;
+	unsigned char high_idx;
+	unsigned char low_bank_no;
+	unsigned char low_idx;
+};
+
+struct asus_primeb550plus_hwmon_chip_field {
+	enum asus_primeb550plus_hwmon_data_type data_type;
+	union {
+		struct asus_primeb550plus_hwmon_data_type_uchar_mul uchar_mul;
+		struct asus_primeb550plus_hwmon_data_type_temp_9bit temp_9bit;
+		struct asus_primeb550plus_hwmon_data_type_temp_8bit temp_8bit;
+		struct asus_primeb550plus_hwmon_data_type_temp_14bit temp_14bit;
+		struct asus_primeb550plus_hwmon_data_type_pwm16 pwm16;
+	} data_address;
+	char const * label;
+};
+
+enum asus_primeb550plus_hwmon_field_list {
+	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_3VCC,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN0,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN8,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN4,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_3VSB,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VBAT,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VTT,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN5,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN6,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN2,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN3,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN7,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_VIN9,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP2,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP3,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP4,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP5,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP6,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_0,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_1,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_0,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_1,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_SMIOVT2,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN0,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN1,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN2,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN3,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN0,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN1,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN2,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN3,
+	ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4,
+
+	ASUS_B550PLUS_HWMON_FIELD_LIST_MAX
+};
+
+#define ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL(_label, _bank_no, _idx_in_bank, _multiplier) \
+	& (const struct asus_primeb550plus_hwmon_chip_field) { \
+		.label = _label, \
+		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL, \
+		.data_address.uchar_mul = { \
+			.bank_no = (_bank_no), \
+			.index_in_bank = (_idx_in_bank), \
+			.multiplier = (_multiplier) \
+		} \
+	}
+
+#define ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT(_label, _int_bank_no, _int_idx, _frac_bank_no, _frac_idx) \
+	& (const struct asus_primeb550plus_hwmon_chip_field) { \
+		.label = _label, \
+		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT, \
+		.data_address.temp_9bit = { \
+			.int_bank_no = (_int_bank_no), \
+			.int_index_in_bank = (_int_idx), \
+			.frac_bank_no = (_frac_bank_no), \
+			.frac_index_in_bank = (_frac_idx), \
+		} \
+	}
+
+#define ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT(_label, _bank_no, _idx) \
+	& (const struct asus_primeb550plus_hwmon_chip_field) { \
+		.label = _label, \
+		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT, \
+		.data_address.temp_8bit = { \
+			.bank_no = (_bank_no), \
+			.index_in_bank = (_idx), \
+		} \
+	}
+
+#define ASUS_B550PLUS_HWMON_FIELD_TEMP_14BIT(_label, _int_bank_no, _int_idx, _frac_bank_no, _frac_idx) \
+	& (const struct asus_primeb550plus_hwmon_chip_field) { \
+		.label = _label, \
+		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT, \
+		.data_address.temp_14bit = { \
+			.int_bank_no = (_int_bank_no), \
+			.int_idx = (_int_idx), \
+			.frac_bank_no = (_frac_bank_no), \
+			.frac_idx = (_frac_idx), \
+		} \
+	}
+
+#define ASUS_B550PLUS_HWMON_FIELD_PWM16(_label, _high_bank_no, _high_idx, _low_bank_no, _low_idx) \
+	& (const struct asus_primeb550plus_hwmon_chip_field) { \
+		.label = _label, \
+		.data_type = ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16, \
+		.data_address.pwm16 = { \
+			.high_bank_no = (_high_bank_no), \
+			.high_idx = (_high_idx), \
+			.low_bank_no = (_low_bank_no), \
+			.low_idx = (_low_idx),\
+		} \
+	}
+
+static struct asus_primeb550plus_hwmon_chip_field const * const asus_primeb550plus_hwmon_chip_fields[ASUS_B550PLUS_HWMON_FIELD_LIST_MAX] = {
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("cpuvcore", 4, 0x80, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin1", 4, 0x81, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("avsb", 4, 0x82, 2*8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_3VCC ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("3vcc", 4, 0x83, 2*8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN0 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin0", 4, 0x84, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN8 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin8", 4, 0x85, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN4 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin4", 4, 0x86, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_3VSB ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("3vsb", 4, 0x87, 2*8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VBAT ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vbat", 4, 0x88, 2*8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VTT ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vtt", 4, 0x89, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN5 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin5", 4, 0x8a, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN6 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin6", 4, 0x8b, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN2 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin2", 4, 0x8c, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN3 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin3", 4, 0x8d, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN7 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin7", 4, 0x8e, 8),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN9 ] = ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL("vin9", 4, 0x8f, 8),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp1", 0, 0x73, 0, 0x74),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp2", 0, 0x75, 0, 0x76),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP3 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp3", 0, 0x77, 0, 0x78),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP4 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp4", 0, 0x79, 0, 0x7a),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP5 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp5", 0, 0x7b, 0, 0x7c),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP6 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("temp6", 0, 0x7d, 0, 0x7e),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent0, dimm0", 4, 0x05),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent0, dimm1", 4, 0x06),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent1, dimm0", 4, 0x07),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_1_1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("agent1, dimm1", 4, 0x08),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SMIOVT2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT("smiovt2 (default cputin)", 1, 0x50, 1, 0x51),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("pch chip", 4, 0x01),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_14BIT("cpu", 4, 0x02, 4, 0x03),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("systin", 4, 0x90),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("cputin", 4, 0x91),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN0 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin0", 4, 0x92),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN1 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin1", 4, 0x93),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN2 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin2", 4, 0x94),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXTIN3 ] = ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT("auxtin3", 4, 0x95),
+
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("sysfan", 4, 0xc0, 4, 0xc1),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("cpufan", 4, 0xc2, 4, 0xc3),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN0 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan0", 4, 0xc4, 4, 0xc5),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN1 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan1", 4, 0xc6, 4, 0xc7),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN2 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan2", 4, 0xc8, 4, 0xc9),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN3 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan3", 4, 0xca, 4, 0xcb),
+	[ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4 ] = ASUS_B550PLUS_HWMON_FIELD_PWM16("auxfan4", 4, 0xce, 4, 0xcf),
+};
+
+#undef ASUS_B550PLUS_HWMON_FIELD_UCHAR_MUL
+#undef ASUS_B550PLUS_HWMON_FIELD_TEMP_9BIT
+#undef ASUS_B550PLUS_HWMON_FIELD_TEMP_8BIT
+#undef ASUS_B550PLUS_HWMON_FIELD_TEMP_14BIT
+#undef ASUS_B550PLUS_HWMON_FIELD_PWM16
+
+/* Range of values a field can decode to, used as default (never tripping) limits */
+static inline void asus_primeb550plus_hwmon_field_range(struct asus_primeb550plus_hwmon_chip_field const * const chip_field, long *lowest, long *highest)
+{
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+			*lowest = 0;
+			*highest = ASUS_B550PLUS_HWMON_U8_MAX * chip_field->data_address.uchar_mul.multiplier;
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+			*lowest = -128500;
+			*highest = 127500;
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			*lowest = -128000;
+			*highest = 127000;
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			*lowest = 0;
+			*highest = ASUS_B550PLUS_HWMON_U8_MAX * 1000 + (ASUS_B550PLUS_HWMON_U8_MAX >> 2);
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
+		default:
+			*lowest = 0;
+			*highest = ASUS_B550PLUS_HWMON_U16_MAX;
+			break;
+	}
+}
+
+/* Change below which a field is considered steady */
+static inline long asus_primeb550plus_hwmon_field_step(struct asus_primeb550plus_hwmon_chip_field const * const chip_field)
+{
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+			return chip_field->data_address.uchar_mul.multiplier;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+			return 500;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			return 1000;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
+		default:
+			return 50;
+	}
+}
+
+/* uchar_mul: one byte, times the field multiplier (mV) */
+static inline long asus_primeb550plus_hwmon_decode_uchar_mul(struct asus_primeb550plus_hwmon_data_type_uchar_mul const * const field, unsigned char raw)
+{
+	return raw * field->multiplier;
+}
+
+/* temp_9bit: signed integer part, half degree in bit 7 of the fractional byte (m°C) */
+static inline long asus_primeb550plus_hwmon_decode_temp_9bit(unsigned char raw_int, unsigned char raw_frac)
+{
+	signed char corrected_int = raw_int;
+	int fractional_value = corrected_int >= 0 ? 500 : -500;
+
+	return corrected_int * 1000 + !!(raw_frac & 0x80) * fractional_value;
+}
+
+/* temp_8bit: signed degrees (m°C) */
+static inline long asus_primeb550plus_hwmon_decode_temp_8bit(unsigned char raw)
+{
+	signed char corrected = raw;
+
+	return corrected * 1000;
+}
+
+/* temp_14bit: unsigned integer part, plus the fractional byte shifted right by 2 (m°C) */
+static inline long asus_primeb550plus_hwmon_decode_temp_14bit(unsigned char raw_int, unsigned char raw_frac)
+{
+	return raw_int * 1000 + (raw_frac >> 2);
+}
+
+/* pwm16: big endian count (RPM) */
+static inline long asus_primeb550plus_hwmon_decode_pwm16(unsigned char raw_high, unsigned char raw_low)
+{
+	return (raw_high << 8) + raw_low;
+}
+
+/* Registers a field is made of, most significant first. Returns how many (1 or 2) */
+static inline unsigned int asus_primeb550plus_hwmon_field_registers(struct asus_primeb550plus_hwmon_chip_field const * const chip_field, unsigned char banks[2], unsigned char indexes[2])
+{
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+			banks[0] = chip_field->data_address.uchar_mul.bank_no;
+			indexes[0] = chip_field->data_address.uchar_mul.index_in_bank;
+			return 1;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+			banks[0] = chip_field->data_address.temp_9bit.int_bank_no;
+			indexes[0] = chip_field->data_address.temp_9bit.int_index_in_bank;
+			banks[1] = chip_field->data_address.temp_9bit.frac_bank_no;
+			indexes[1] = chip_field->data_address.temp_9bit.frac_index_in_bank;
+			return 2;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			banks[0] = chip_field->data_address.temp_8bit.bank_no;
+			indexes[0] = chip_field->data_address.temp_8bit.index_in_bank;
+			return 1;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			banks[0] = chip_field->data_address.temp_14bit.int_bank_no;
+			indexes[0] = chip_field->data_address.temp_14bit.int_idx;
+			banks[1] = chip_field->data_address.temp_14bit.frac_bank_no;
+			indexes[1] = chip_field->data_address.temp_14bit.frac_idx;
+			return 2;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
+		default:
+			banks[0] = chip_field->data_address.pwm16.high_bank_no;
+			indexes[0] = chip_field->data_address.pwm16.high_idx;
+			banks[1] = chip_field->data_address.pwm16.low_bank_no;
+			indexes[1] = chip_field->data_address.pwm16.low_idx;
+			return 2;
+	}
+}
+
+/* Decodes the bytes of the registers given by asus_primeb550plus_hwmon_field_registers() */
+static inline long asus_primeb550plus_hwmon_decode_field(struct asus_primeb550plus_hwmon_chip_field const * const chip_field, unsigned char const raw[2])
+{
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+			return asus_primeb550plus_hwmon_decode_uchar_mul(&chip_field->data_address.uchar_mul, raw[0]);
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+			return asus_primeb550plus_hwmon_decode_temp_9bit(raw[0], raw[1]);
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			return asus_primeb550plus_hwmon_decode_temp_8bit(raw[0]);
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			return asus_primeb550plus_hwmon_decode_temp_14bit(raw[0], raw[1]);
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
+		default:
+			return asus_primeb550plus_hwmon_decode_pwm16(raw[0], raw[1]);
+	}
+}
+
+#endif
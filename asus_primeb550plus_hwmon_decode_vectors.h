@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Known register values of asus_primeb550plus_hwmon_decode.h fields and
+ * what they read as, from the chip documentation. Shared by the KUnit
+ * suite, which sets them on an emulated register file, and tools/.
+ */
+
+#ifndef ASUS_PRIMEB550PLUS_HWMON_DECODE_VECTORS_H
+#define ASUS_PRIMEB550PLUS_HWMON_DECODE_VECTORS_H
+
+#include "asus_primeb550plus_hwmon_decode.h"
+
+struct asus_primeb550plus_hwmon_decode_vector {
+	enum asus_primeb550plus_hwmon_field_list field;
+	unsigned char raw[2];	/* in the order of asus_primeb550plus_hwmon_field_registers() */
+	long expected;
+};
+
+static const struct asus_primeb550plus_hwmon_decode_vector asus_primeb550plus_hwmon_decode_vectors[] = {
+	/* 8 mV or 16 mV per LSB */
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE, { 0x00, 0x00 }, 0 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUVCORE, { 0x80, 0x00 }, 1024 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_VIN1, { 0xff, 0x00 }, 2040 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_AVSB, { 0xcf, 0x00 }, 3312 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_3VSB, { 0xff, 0x00 }, 4080 },
+
+	/* Signed degrees, bit 7 of the second register is half a degree away from 0 */
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x00, 0x00 }, 0 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x00, 0x80 }, 500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x19, 0x00 }, 25000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x19, 0x80 }, 25500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x19, 0x7f }, 25000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x7f, 0x80 }, 127500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x7f, 0xff }, 127500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0xff, 0x00 }, -1000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0xff, 0x80 }, -1500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0xe7, 0x80 }, -25500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMP1, { 0x80, 0x80 }, -128500 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_SMIOVT2, { 0x2d, 0x80 }, 45500 },
+
+	/* Signed degrees */
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_TEMPDIMM_0_0, { 0x2d, 0x00 }, 45000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CHIP_TEMP, { 0x7f, 0x00 }, 127000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSTIN, { 0x80, 0x00 }, -128000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUTIN, { 0xff, 0x00 }, -1000 },
+
+	/* Unsigned degrees, then 1/64 degree in the top bits of the second register */
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP, { 0x2d, 0x00 }, 45000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP, { 0x2d, 0x03 }, 45000 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP, { 0x2d, 0x04 }, 45001 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_PCH_CPU_TEMP, { 0xff, 0xff }, 255063 },
+
+	/* Big endian RPM */
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_SYSFANIN, { 0x04, 0xb0 }, 1200 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_CPUFANIN, { 0x00, 0x00 }, 0 },
+	{ ASUS_B550PLUS_HWMON_FIELD_LIST_AUXFANIN4, { 0xff, 0xff }, 65535 },
+};
+
+#define ASUS_B550PLUS_HWMON_DECODE_VECTORS	(sizeof(asus_primeb550plus_hwmon_decode_vectors) / sizeof(asus_primeb550plus_hwmon_decode_vectors[0]))
+
+#endif
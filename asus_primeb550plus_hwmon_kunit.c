@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * KUnit tests of asus_primeb550plus_hwmon. Registers are set on an
+ * emulated register file and fields are read through the driver read
+ * path, expected values come from the chip documentation (see
+ * asus_primeb550plus_hwmon_decode_vectors.h).
+ */
+
+#include <kunit/test.h>
+#include <kunit/device.h>
+#include <linux/module.h>
+
+#include "asus_primeb550plus_hwmon_decode_vectors.h"
+#include "asus_primeb550plus_hwmon_kunit.h"
+
+#define ASUS_B550PLUS_HWMON_KUNIT_ID_BANK		0
+#define ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_INDEX	0x4f
+#define ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID_INDEX		0x58
+#define ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_HIGH	0x5c
+#define ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID		0xc1
+
+static void asus_primeb550plus_hwmon_kunit_release(void *data)
+{
+	asus_primeb550plus_hwmon_kunit_free(data);
+}
+
+static struct asus_primeb550plus_hwmon_data *asus_primeb550plus_hwmon_kunit_data(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_alloc();
+
+	KUNIT_ASSERT_NOT_NULL(test, devdri_data);
+	KUNIT_ASSERT_EQ(test, kunit_add_action_or_reset(test, asus_primeb550plus_hwmon_kunit_release, devdri_data), 0);
+	return devdri_data;
+}
+
+static void asus_primeb550plus_hwmon_kunit_expect(struct kunit *test, struct asus_primeb550plus_hwmon_data *devdri_data, const char *label, long expected)
+{
+	long val = 0;
+
+	KUNIT_EXPECT_EQ_MSG(test, asus_primeb550plus_hwmon_kunit_read_field(devdri_data, label, &val), 0, "%s", label);
+	KUNIT_EXPECT_EQ_MSG(test, val, expected, "%s", label);
+}
+
+/* Known values of every field type, read alone and as a sweep */
+static void asus_primeb550plus_hwmon_kunit_vectors(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_DECODE_VECTORS ; i++) {
+		struct asus_primeb550plus_hwmon_decode_vector const * const vector = &asus_primeb550plus_hwmon_decode_vectors[i];
+		struct asus_primeb550plus_hwmon_chip_field const * const chip_field = asus_primeb550plus_hwmon_chip_fields[vector->field];
+		unsigned char banks[2], indexes[2];
+		unsigned int registers, j;
+		long val = 0;
+
+		registers = asus_primeb550plus_hwmon_field_registers(chip_field, banks, indexes);
+		for (j=0 ; j<registers ; j++)
+			asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, banks[j], indexes[j], vector->raw[j]);
+
+		asus_primeb550plus_hwmon_kunit_expect(test, devdri_data, chip_field->label, vector->expected);
+		KUNIT_EXPECT_EQ_MSG(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, chip_field->label, &val), 0, "%s", chip_field->label);
+		KUNIT_EXPECT_EQ_MSG(test, val, vector->expected, "%s: 0x%02x 0x%02x", chip_field->label, vector->raw[0], vector->raw[1]);
+	}
+}
+
+/* The high byte moves while the low one is read: read again, or give up */
+static void asus_primeb550plus_hwmon_kunit_torn_pair(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	u64 retries, failures;
+	long val;
+
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc2, 0x04);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc3, 0xb0);
+	asus_primeb550plus_hwmon_kunit_glitch_reg(devdri_data, 4, 0xc2, 1);
+	asus_primeb550plus_hwmon_kunit_expect(test, devdri_data, "cpufan", 0x05b0);
+	asus_primeb550plus_hwmon_kunit_paired_reads(devdri_data, &retries, &failures);
+	KUNIT_EXPECT_EQ(test, retries, 1);
+	KUNIT_EXPECT_EQ(test, failures, 0);
+
+	asus_primeb550plus_hwmon_kunit_glitch_reg(devdri_data, 4, 0xc2, 16);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_read_field(devdri_data, "cpufan", &val), -EAGAIN);
+	asus_primeb550plus_hwmon_kunit_paired_reads(devdri_data, &retries, &failures);
+	KUNIT_EXPECT_GT(test, retries, 1);
+	KUNIT_EXPECT_EQ(test, failures, 1);
+}
+
+/* A sweep reads registers grouped by bank, then the high bytes of two-byte fields again */
+static void asus_primeb550plus_hwmon_kunit_plan(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	long val = 0;
+
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0x80, 0x80);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 0, 0x73, 0xff);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 0, 0x74, 0x80);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0x02, 0x2d);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0x03, 0x04);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc0, 0x04);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc1, 0xb0);
+
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpuvcore", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, 1024);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "temp1", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, -1500);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpu", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, 45001);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "sysfan", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, 1200);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_verify_mismatches(devdri_data), 0);
+}
+
+/*
+ * The high byte moves between the sweep read and its verify read: the
+ * field is read again on its own, which only retries if it moves again.
+ */
+static void asus_primeb550plus_hwmon_kunit_plan_torn(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	u64 retries, failures;
+	long val = 0;
+
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc2, 0x04);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0xc3, 0xb0);
+	asus_primeb550plus_hwmon_kunit_glitch_reg(devdri_data, 4, 0xc2, 1);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpufan", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, 0x05b0);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_verify_mismatches(devdri_data), 1);
+	asus_primeb550plus_hwmon_kunit_paired_reads(devdri_data, &retries, &failures);
+	KUNIT_EXPECT_EQ(test, retries, 0);
+	KUNIT_EXPECT_EQ(test, failures, 0);
+
+	/* Still moving: the paired read gives up */
+	asus_primeb550plus_hwmon_kunit_glitch_reg(devdri_data, 4, 0xc2, 16);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpufan", &val), -EAGAIN);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_verify_mismatches(devdri_data), 2);
+	asus_primeb550plus_hwmon_kunit_paired_reads(devdri_data, &retries, &failures);
+	KUNIT_EXPECT_GT(test, retries, 0);
+	KUNIT_EXPECT_EQ(test, failures, 1);
+
+	/* A one-byte field is not read again */
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, 4, 0x80, 0x80);
+	asus_primeb550plus_hwmon_kunit_glitch_reg(devdri_data, 4, 0x80, 1);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpuvcore", &val), 0);
+	KUNIT_EXPECT_EQ(test, val, 1024);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_verify_mismatches(devdri_data), 2);
+}
+
+static void asus_primeb550plus_hwmon_kunit_read_error(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	long val;
+
+	asus_primeb550plus_hwmon_kunit_fail_reg(devdri_data, 0, 0x74);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_read_field(devdri_data, "temp1", &val), -EIO);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "temp1", &val), -EIO);
+	asus_primeb550plus_hwmon_kunit_expect(test, devdri_data, "temp2", 0);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpuvcore", &val), 0);
+}
+
+/* An open breaker refuses reads of its bank only */
+static void asus_primeb550plus_hwmon_kunit_breaker_open(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	long val;
+
+	asus_primeb550plus_hwmon_kunit_open_breaker(devdri_data, 0);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_read_field(devdri_data, "temp1", &val), -EBUSY);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "temp1", &val), -EBUSY);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_read_field(devdri_data, "cpuvcore", &val), 0);
+	KUNIT_EXPECT_EQ(test, asus_primeb550plus_hwmon_kunit_plan_read(devdri_data, "cpuvcore", &val), 0);
+}
+
+static void asus_primeb550plus_hwmon_kunit_check_chip_ids(struct kunit *test)
+{
+	struct asus_primeb550plus_hwmon_data *devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	struct device *dev = kunit_device_register(test, "asus_primeb550plus_hwmon_kunit");
+	static const struct {
+		unsigned char vendor_id_high, chip_id;
+		bool supported;
+	} ids[] = {
+		{ ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_HIGH, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID, true },
+		{ 0x00, 0x00, false },
+		{ ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_HIGH, 0x00, false },
+		{ 0x00, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID, false },
+		{ ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID, ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_HIGH, false },
+	};
+	size_t i;
+
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, dev);
+
+	for (i=0 ; i<ARRAY_SIZE(ids) ; i++) {
+		asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK, ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_INDEX, ids[i].vendor_id_high);
+		asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID_INDEX, ids[i].chip_id);
+		if (ids[i].supported)
+			KUNIT_EXPECT_EQ_MSG(test, asus_primeb550plus_hwmon_kunit_check_chip(dev, devdri_data), 0, "ids %zu", i);
+		else
+			KUNIT_EXPECT_NE_MSG(test, asus_primeb550plus_hwmon_kunit_check_chip(dev, devdri_data), 0, "ids %zu", i);
+	}
+
+	/* Ids that cannot be read are not a supported chip */
+	asus_primeb550plus_hwmon_kunit_fail_reg(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID_INDEX);
+	KUNIT_EXPECT_NE(test, asus_primeb550plus_hwmon_kunit_check_chip(dev, devdri_data), 0);
+
+	devdri_data = asus_primeb550plus_hwmon_kunit_data(test);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK, ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_INDEX, ASUS_B550PLUS_HWMON_KUNIT_VENDOR_ID_HIGH);
+	asus_primeb550plus_hwmon_kunit_set_reg(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID_INDEX, ASUS_B550PLUS_HWMON_KUNIT_CHIP_ID);
+	asus_primeb550plus_hwmon_kunit_open_breaker(devdri_data, ASUS_B550PLUS_HWMON_KUNIT_ID_BANK);
+	KUNIT_EXPECT_NE(test, asus_primeb550plus_hwmon_kunit_check_chip(dev, devdri_data), 0);
+}
+
+static struct kunit_case asus_primeb550plus_hwmon_kunit_cases[] = {
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_vectors),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_torn_pair),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_plan),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_plan_torn),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_read_error),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_breaker_open),
+	KUNIT_CASE(asus_primeb550plus_hwmon_kunit_check_chip_ids),
+	{}
+};
+
+static struct kunit_suite asus_primeb550plus_hwmon_kunit_suite = {
+	.name = "asus_primeb550plus_hwmon",
+	.test_cases = asus_primeb550plus_hwmon_kunit_cases,
+};
+kunit_test_suite(asus_primeb550plus_hwmon_kunit_suite);
+
+MODULE_DESCRIPTION("KUnit tests of asus_primeb550plus_hwmon");
+MODULE_LICENSE("GPL");
+MODULE_IMPORT_NS("EXPORTED_FOR_KUNIT_TESTING");
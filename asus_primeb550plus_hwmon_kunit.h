@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * What asus_primeb550plus_hwmon exports (EXPORT_SYMBOL_IF_KUNIT) to its
+ * KUnit suite: an instance over an emulated register file, on which a
+ * register can be made to move right after it is read, or to fail.
+ */
+
+#ifndef ASUS_PRIMEB550PLUS_HWMON_KUNIT_H
+#define ASUS_PRIMEB550PLUS_HWMON_KUNIT_H
+
+#include <linux/types.h>
+
+struct device;
+struct asus_primeb550plus_hwmon_data;
+
+struct asus_primeb550plus_hwmon_data *asus_primeb550plus_hwmon_kunit_alloc(void);
+void asus_primeb550plus_hwmon_kunit_free(struct asus_primeb550plus_hwmon_data *devdri_data);
+
+void asus_primeb550plus_hwmon_kunit_set_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned char value);
+/* The next count reads of the register each increment it once done */
+void asus_primeb550plus_hwmon_kunit_glitch_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index, unsigned int count);
+/* Reads of the register fail with -EIO */
+void asus_primeb550plus_hwmon_kunit_fail_reg(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank, unsigned char index);
+
+/* Reads the field with that label through read_field, -ENOENT if none */
+int asus_primeb550plus_hwmon_kunit_read_field(struct asus_primeb550plus_hwmon_data *devdri_data, const char *label, long *val);
+/* Same, through plan_read, as a sweep due for that field alone */
+int asus_primeb550plus_hwmon_kunit_plan_read(struct asus_primeb550plus_hwmon_data *devdri_data, const char *label, long *val);
+void asus_primeb550plus_hwmon_kunit_paired_reads(struct asus_primeb550plus_hwmon_data *devdri_data, u64 *retries, u64 *failures);
+u64 asus_primeb550plus_hwmon_kunit_verify_mismatches(struct asus_primeb550plus_hwmon_data *devdri_data);
+/* Reads of the bank are refused, as after repeated failures */
+void asus_primeb550plus_hwmon_kunit_open_breaker(struct asus_primeb550plus_hwmon_data *devdri_data, unsigned char bank);
+int asus_primeb550plus_hwmon_kunit_check_chip(struct device *dev, struct asus_primeb550plus_hwmon_data *devdri_data);
+
+#endif
@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Tracepoints of asus_primeb550plus_hwmon.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM asus_primeb550plus_hwmon
+
+#if !defined(ASUS_PRIMEB550PLUS_HWMON_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define ASUS_PRIMEB550PLUS_HWMON_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/* One register read through the backend, value is 0 when err is set */
+TRACE_EVENT(asus_primeb550plus_hwmon_read_u8,
+
+	TP_PROTO(const char *backend, unsigned char bank, unsigned char index, unsigned char value, int err, u64 duration_ns),
+
+	TP_ARGS(backend, bank, index, value, err, duration_ns),
+
+	TP_STRUCT__entry(
+		__string(backend, backend)
+		__field(unsigned char, bank)
+		__field(unsigned char, index)
+		__field(unsigned char, value)
+		__field(int, err)
+		__field(u64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__assign_str(backend);
+		__entry->bank = bank;
+		__entry->index = index;
+		__entry->value = value;
+		__entry->err = err;
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("backend=%s bank=%u index=0x%02x value=0x%02x err=%d duration_ns=%llu",
+		__get_str(backend), __entry->bank, __entry->index, __entry->value, __entry->err, __entry->duration_ns)
+);
+
+#endif
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE asus_primeb550plus_hwmon_trace
+#include <trace/define_trace.h>
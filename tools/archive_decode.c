@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Decodes the debugfs archive of asus_primeb550plus_hwmon (format in
+ * asus_primeb550plus_hwmon.h) to CSV on stdout: time_ns, then a column per
+ * channel in driver field order, empty when the channel was not valid.
+ * Blocks are read in host byte order, as the kernel wrote them.
+ *
+ *	archive_decode [file]	(default stdin)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "asus_primeb550plus_hwmon.h"
+
+#define ARCHIVE_DECODE_NR_IN	16
+#define ARCHIVE_DECODE_NR_TEMP	19
+
+/* LEB128 at *pos, -1 when it runs past the used bytes */
+static int archive_decode_varint(unsigned char const *payload, size_t used, size_t *pos, uint64_t *value)
+{
+	unsigned int shift = 0;
+
+	*value = 0;
+	while (*pos < used && shift < 64) {
+		unsigned char const byte = payload[(*pos)++];
+
+		*value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return 0;
+		shift += 7;
+	}
+
+	return -1;
+}
+
+static int64_t archive_decode_zigzag(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void archive_decode_columns(void)
+{
+	unsigned int n;
+
+	printf("time_ns");
+	for (n=0 ; n<ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS ; n++) {
+		if (n < ARCHIVE_DECODE_NR_IN)
+			printf(",in%u", n);
+		else if (n < ARCHIVE_DECODE_NR_IN + ARCHIVE_DECODE_NR_TEMP)
+			printf(",temp%u", n - ARCHIVE_DECODE_NR_IN + 1);
+		else
+			printf(",fan%u", n - ARCHIVE_DECODE_NR_IN - ARCHIVE_DECODE_NR_TEMP + 1);
+	}
+	putchar('\n');
+}
+
+/* Prints every sample of block, returns 0 when the whole block decoded */
+static int archive_decode_block(struct asus_primeb550plus_hwmon_archive_block const *block)
+{
+	int64_t values[ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS] = { 0 };
+	uint64_t time = block->start_ns, valid = block->channels, value;
+	size_t pos = 0;
+	unsigned int i, n;
+
+	if (block->used > sizeof(block->payload))
+		return -1;
+
+	for (i=0 ; i<block->nr_samples ; i++) {
+		if (archive_decode_varint(block->payload, block->used, &pos, &value))
+			return -1;
+		time += value * 1000000;
+		if (archive_decode_varint(block->payload, block->used, &pos, &value))
+			return -1;
+		valid ^= value;
+
+		for (n=0 ; n<ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS ; n++) {
+			if (!(valid & (1ULL << n)))
+				continue;
+			if (archive_decode_varint(block->payload, block->used, &pos, &value))
+				return -1;
+			values[n] += archive_decode_zigzag(value);
+		}
+
+		printf("%llu", (unsigned long long)time);
+		for (n=0 ; n<ASUS_PRIMEB550PLUS_HWMON_NR_CHANNELS ; n++) {
+			if (valid & (1ULL << n))
+				printf(",%lld", (long long)values[n]);
+			else
+				putchar(',');
+		}
+		putchar('\n');
+	}
+
+	return pos == block->used ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+	static struct asus_primeb550plus_hwmon_archive_block block;
+	unsigned long long nr_blocks = 0;
+	FILE *f = stdin;
+	size_t len;
+
+	if (argc > 2 || (argc == 2 && !strcmp(argv[1], "-h"))) {
+		fprintf(stderr, "usage: %s [file]\n", argv[0]);
+		return 1;
+	}
+	if (argc == 2 && !(f = fopen(argv[1], "rb"))) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	archive_decode_columns();
+	while ((len = fread(&block, 1, sizeof(block), f)) == sizeof(block)) {
+		if (block.magic != ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_MAGIC || block.version != ASUS_PRIMEB550PLUS_HWMON_ARCHIVE_VERSION) {
+			fprintf(stderr, "block %llu: bad magic or version %u\n", nr_blocks, block.version);
+			return 1;
+		}
+		if (archive_decode_block(&block)) {
+			fprintf(stderr, "block %llu (sequence %llu): corrupted payload\n", nr_blocks, (unsigned long long)block.sequence);
+			return 1;
+		}
+		nr_blocks++;
+	}
+
+	if (ferror(f) || len) {
+		fprintf(stderr, "%s\n", ferror(f) ? "read error" : "truncated block");
+		return 1;
+	}
+	if (f != stdin)
+		fclose(f);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Throughput of the decoders of asus_primeb550plus_hwmon_decode.h over
+ * the whole field table, on a set of pseudo-random register bytes.
+ *
+ *	decode_bench [sweeps]	(default 10000000)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "asus_primeb550plus_hwmon_decode.h"
+
+/* Different sets of register bytes, cycled through */
+#define DECODE_BENCH_SETS	1024
+
+static unsigned char decode_bench_raw[DECODE_BENCH_SETS][ASUS_B550PLUS_HWMON_FIELD_LIST_MAX][2];
+
+static unsigned long long decode_bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long long sweeps = 10000000, n, start, elapsed;
+	unsigned int seed = 1;
+	volatile long sink;
+	long sum = 0;
+	size_t i, j;
+
+	if (argc > 1 && !(sweeps = strtoull(argv[1], NULL, 0))) {
+		fprintf(stderr, "usage: %s [sweeps]\n", argv[0]);
+		return 1;
+	}
+
+	for (i=0 ; i<DECODE_BENCH_SETS ; i++) {
+		for (j=0 ; j<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; j++) {
+			seed = seed * 1103515245 + 12345;
+			decode_bench_raw[i][j][0] = seed >> 16;
+			decode_bench_raw[i][j][1] = seed >> 24;
+		}
+	}
+
+	start = decode_bench_now_ns();
+	for (n=0 ; n<sweeps ; n++) {
+		unsigned char (* const raw)[2] = decode_bench_raw[n % DECODE_BENCH_SETS];
+
+		for (j=0 ; j<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; j++)
+			sum += asus_primeb550plus_hwmon_decode_field(asus_primeb550plus_hwmon_chip_fields[j], raw[j]);
+	}
+	elapsed = decode_bench_now_ns() - start;
+	sink = sum;
+	(void)sink;
+
+	printf("sweeps %llu\n", sweeps);
+	printf("fields %llu\n", sweeps * ASUS_B550PLUS_HWMON_FIELD_LIST_MAX);
+	printf("elapsed_ns %llu\n", elapsed);
+	printf("sweep_ns %.2f\n", (double)elapsed / sweeps);
+	printf("field_ns %.3f\n", (double)elapsed / (sweeps * ASUS_B550PLUS_HWMON_FIELD_LIST_MAX));
+	printf("fields_per_s %.0f\n", sweeps * ASUS_B550PLUS_HWMON_FIELD_LIST_MAX * 1e9 / (elapsed ? elapsed : 1));
+
+	return 0;
+}
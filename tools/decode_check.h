@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Checks shared by decode_test and decode_fuzz. They do not work out
+ * values again, they check what any right decoding has to satisfy: the
+ * field range, the sign of the register, bits the type ignores, and
+ * monotonicity in the register bytes.
+ */
+
+#ifndef DECODE_CHECK_H
+#define DECODE_CHECK_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "asus_primeb550plus_hwmon_decode.h"
+
+/*
+ * Raw bytes just before raw in the order values of the type grow with:
+ * the first byte (signed for temperatures) for one-byte types and
+ * temp_9bit, both bytes big endian otherwise. Returns 0 when raw is the
+ * lowest. *strict is cleared when equal values are allowed (temp_14bit
+ * drops two bits).
+ */
+static inline int decode_check_previous(enum asus_primeb550plus_hwmon_data_type data_type, unsigned char const raw[2], unsigned char previous[2], int *strict)
+{
+	previous[0] = raw[0];
+	previous[1] = raw[1];
+	*strict = 1;
+
+	switch(data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+			if (!raw[0])
+				return 0;
+			previous[0]--;
+			return 1;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			if (raw[0] == 0x80)
+				return 0;
+			previous[0]--;
+			return 1;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			*strict = 0;
+			/* fallthrough */
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_PWM16:
+		default:
+			if (!raw[0] && !raw[1])
+				return 0;
+			if (!previous[1]--)
+				previous[0]--;
+			return 1;
+	}
+}
+
+/*
+ * Decodes raw as field field_index and checks the value. Returns 0 when
+ * fine, prints what is wrong otherwise.
+ */
+static inline int decode_check(size_t field_index, unsigned char const raw[2])
+{
+	struct asus_primeb550plus_hwmon_chip_field const *chip_field;
+	unsigned char other[2];
+	long value, lowest, highest;
+	int negative, strict;
+
+	if (field_index >= ASUS_B550PLUS_HWMON_FIELD_LIST_MAX || !(chip_field = asus_primeb550plus_hwmon_chip_fields[field_index])) {
+		fprintf(stderr, "field %zu: not in the table\n", field_index);
+		return 1;
+	}
+
+	value = asus_primeb550plus_hwmon_decode_field(chip_field, raw);
+	asus_primeb550plus_hwmon_field_range(chip_field, &lowest, &highest);
+	if (value < lowest || value > highest) {
+		fprintf(stderr, "%s: 0x%02x 0x%02x decodes to %ld, out of [%ld, %ld]\n", chip_field->label, raw[0], raw[1], value, lowest, highest);
+		return 1;
+	}
+
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			negative = raw[0] & 0x80;
+			break;
+		default:
+			negative = 0;
+			break;
+	}
+	if (!negative != (value >= 0)) {
+		fprintf(stderr, "%s: 0x%02x 0x%02x decodes to %ld, wrong sign\n", chip_field->label, raw[0], raw[1], value);
+		return 1;
+	}
+
+	/* Bits of the second byte the type ignores: all of them for one-byte types, all but the half degree or 1/64 degree bits otherwise */
+	other[0] = raw[0];
+	other[1] = raw[1];
+	switch(chip_field->data_type) {
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_UCHAR_MUL:
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_8BIT:
+			other[1] ^= 0xff;
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_9BIT:
+			other[1] ^= 0x7f;
+			break;
+		case ASUS_B550PLUS_HWMON_DATA_TYPE_TEMP_14BIT:
+			other[1] ^= 0x03;
+			break;
+		default:
+			break;
+	}
+	if (asus_primeb550plus_hwmon_decode_field(chip_field, other) != value) {
+		fprintf(stderr, "%s: 0x%02x 0x%02x decodes to %ld, but 0x%02x 0x%02x does not\n", chip_field->label, raw[0], raw[1], value, other[0], other[1]);
+		return 1;
+	}
+
+	if (decode_check_previous(chip_field->data_type, raw, other, &strict)) {
+		long const previous_value = asus_primeb550plus_hwmon_decode_field(chip_field, other);
+
+		if (strict ? previous_value >= value : previous_value > value) {
+			fprintf(stderr, "%s: 0x%02x 0x%02x decodes to %ld, not above %ld of 0x%02x 0x%02x\n", chip_field->label, raw[0], raw[1], value, previous_value, other[0], other[1]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+#endif
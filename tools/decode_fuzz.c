@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * libFuzzer target over the decoders of asus_primeb550plus_hwmon_decode.h.
+ * An input is a field index (modulo the number of fields) followed by
+ * the two register bytes, any failed check of decode_check.h aborts.
+ *
+ * Built without libFuzzer (DECODE_FUZZ_STANDALONE), main() runs the files
+ * given as arguments (a corpus, or crashes found by libFuzzer). Every
+ * input is covered by decode_test already.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "decode_check.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	unsigned char raw[2] = { 0, 0 };
+
+	if (size < 1)
+		return 0;
+	if (size > 1)
+		raw[0] = data[1];
+	if (size > 2)
+		raw[1] = data[2];
+
+	if (decode_check(data[0] % ASUS_B550PLUS_HWMON_FIELD_LIST_MAX, raw))
+		abort();
+
+	return 0;
+}
+
+#ifdef DECODE_FUZZ_STANDALONE
+int main(int argc, char **argv)
+{
+	int i;
+
+	for (i=1 ; i<argc ; i++) {
+		uint8_t input[64];
+		size_t size;
+		FILE *f;
+
+		if (!(f = fopen(argv[i], "rb"))) {
+			perror(argv[i]);
+			return 1;
+		}
+		size = fread(input, 1, sizeof(input), f);
+		fclose(f);
+
+		LLVMFuzzerTestOneInput(input, size);
+	}
+
+	printf("PASS: %d inputs\n", argc - 1);
+
+	return 0;
+}
+#endif
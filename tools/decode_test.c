@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * Copyright (C) 2021 Etienne Buira <etienne.buira@free.fr>
+ *
+ * Userspace test of asus_primeb550plus_hwmon_decode.h: the known values
+ * of asus_primeb550plus_hwmon_decode_vectors.h, then the checks of
+ * decode_check.h on every field over every pair of bytes.
+ */
+
+#include <stdio.h>
+
+#include "asus_primeb550plus_hwmon_decode_vectors.h"
+#include "decode_check.h"
+
+int main(void)
+{
+	unsigned int failures = 0;
+	size_t i;
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_DECODE_VECTORS ; i++) {
+		struct asus_primeb550plus_hwmon_decode_vector const * const vector = &asus_primeb550plus_hwmon_decode_vectors[i];
+		struct asus_primeb550plus_hwmon_chip_field const * const chip_field = asus_primeb550plus_hwmon_chip_fields[vector->field];
+		long const value = asus_primeb550plus_hwmon_decode_field(chip_field, vector->raw);
+
+		if (value != vector->expected) {
+			fprintf(stderr, "%s: 0x%02x 0x%02x decodes to %ld, expected %ld\n", chip_field->label, vector->raw[0], vector->raw[1], value, vector->expected);
+			failures++;
+		}
+	}
+
+	for (i=0 ; i<ASUS_B550PLUS_HWMON_FIELD_LIST_MAX ; i++) {
+		unsigned int a, b;
+
+		for (a=0 ; a<=ASUS_B550PLUS_HWMON_U8_MAX ; a++) {
+			for (b=0 ; b<=ASUS_B550PLUS_HWMON_U8_MAX ; b++) {
+				unsigned char const raw[2] = { a, b };
+
+				failures += decode_check(i, raw);
+			}
+		}
+	}
+
+	printf("%s: %u failures\n", failures ? "FAIL" : "PASS", failures);
+
+	return !!failures;
+}